@@ -4,6 +4,9 @@
 #include <set>
 #include <functional>
 
+#include "fastio.hpp"
+#include "solver_stats.hpp"
+
 using namespace std;
 
 class BipartiteMatchingKonig {
@@ -14,6 +17,8 @@ private:
     vector<int> X, Y;           // Left and right vertex sets
     vector<int> matching;       // Matching information: matching[v] = u means v is matched to u
     set<int> min_vertex_cover;  // Minimum vertex cover
+    SolverStats st;             // Counters of the last solve (SOLVER_STATS builds)
+    int flips = 0;              // Matching edges set by the current search
 
     // DFS function for finding augmenting paths
     std::function<bool(int, vector<bool>&, vector<bool>&)> dfs;
@@ -67,6 +72,7 @@ private:
             inQueue[u] = true;
             
             for (int v : graph[u]) {
+                STATS(st.arcs_scanned++);
                 // Only consider edges from X to Y
                 if (color[u] == color[v]) continue;
                 
@@ -74,6 +80,7 @@ private:
                 if (matching[v] == -1 || (!inQueue[matching[v]] && dfs(matching[v], visited, inQueue))) {
                     matching[v] = u;
                     matching[u] = v;
+                    STATS(flips++);
                     return true;
                 }
             }
@@ -82,10 +89,15 @@ private:
         };
         
         // Find augmenting paths
+        st.reset();
+        PhaseClock clock;
         for (int i : X) {
             vector<bool> visited(n, false);
             vector<bool> inQueue(n, false);
-            dfs(i, visited, inQueue);
+            flips = 0;
+            if (dfs(i, visited, inQueue)) STATS(st.path(2 * flips - 1));
+            STATS(st.phases++);
+            clock.lap(st);
         }
     }
     
@@ -191,16 +203,24 @@ public:
     set<int> getMinVertexCover() {
         return min_vertex_cover;
     }
+    
+    // Get the counters of the matching search (zero unless built with SOLVER_STATS)
+    const SolverStats& stats() const {
+        return st;
+    }
 };
 
 int main() {
-    int n, m;
-    cin >> n >> m;
+    FastInput in;
+    FastOutput out;
+    int n = 0, m = 0;
+    in.next(n, m);
     
     vector<pair<int, int>> edges;
+    edges.reserve(m);
     for (int i = 0; i < m; ++i) {
-        int u, v;
-        cin >> u >> v;
+        int u = 0, v = 0;
+        in.next(u, v);
         edges.push_back({u, v});
     }
     
@@ -212,17 +232,20 @@ int main() {
     vector<pair<int, int>> matched_edges = solver.getMatchedEdges();
     int min_cover_size = solver.getMinVertexCoverSize();
     set<int> min_cover = solver.getMinVertexCover();
+#ifdef SOLVER_STATS
+    solver.stats().dump(stderr, "konig");
+#endif
     
     // Output the results
-    cout << max_matching_size << endl;
+    out << max_matching_size << '\n';
     for (const auto& edge : matched_edges) {
-        cout << edge.first << " " << edge.second << endl;
+        out << edge.first << ' ' << edge.second << '\n';
     }
-    cout << min_cover_size << endl;
+    out << min_cover_size << '\n';
     for (int vertex : min_cover) {
-        cout << vertex << " ";
+        out << vertex << ' ';
     }
-    cout << endl;
+    out << '\n';
     
     return 0;
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include <vector>
 #include <queue>
 #include <algorithm>
+
+#include "fastio.hpp"
+#include "solver_stats.hpp"
+
 using namespace std;
 
 const int MAXN = 505; // Maximum number of vertices
@@ -10,6 +14,7 @@ int n, m;
 vector<int> g[MAXN];  // Adjacency list representation of the graph
 int match[MAXN], p[MAXN], base[MAXN];
 bool used[MAXN], blossom[MAXN];
+SolverStats stats;    // Counters of all findPath calls (only with SOLVER_STATS)
 
 // Find the lowest common ancestor (LCA) of two vertices in the alternating tree
 int lca(int a, int b) {
@@ -50,17 +55,21 @@ int findPath(int start) {
     queue<int> q;
     q.push(start);
     used[start] = true;
+    PhaseClock clock;
+    STATS(stats.phases++);
     
     while (!q.empty()) {
         int v = q.front();
         q.pop();
         for (int u : g[v]) {
+            STATS(stats.arcs_scanned++);
             // Skip if u and v belong to the same blossom or if u is the matched partner of v
             if (base[v] == base[u] || match[v] == u)
                 continue;
             // If we found a cycle or the alternating tree already contains a path from u
             if (u == start || (match[u] != -1 && p[match[u]] != -1)) {
                 int cur = lca(v, u);
+                STATS(stats.blossoms++);
                 fill(blossom, blossom + n, false);
                 markPath(v, cur, u);
                 markPath(u, cur, v);
@@ -77,6 +86,7 @@ int findPath(int start) {
                 p[u] = v;
                 // If u is not matched, an augmenting path is found
                 if (match[u] == -1) {
+                    STATS(int len = -1; for (int c = u; c != -1; c = match[p[c]]) len += 2; stats.path(len));
                     int cur = u;
                     while (cur != -1) {
                         int pv = p[cur];
@@ -85,6 +95,7 @@ int findPath(int start) {
                         match[pv] = cur;
                         cur = w;
                     }
+                    clock.lap(stats);
                     return 1;
                 } else {
                     used[match[u]] = true;
@@ -93,17 +104,18 @@ int findPath(int start) {
             }
         }
     }
+    clock.lap(stats);
     return 0;
 }
 
 int main(){
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
+    FastInput in;
+    FastOutput out;
     
-    cin >> n >> m;
+    in.next(n, m);
     for (int i = 0; i < m; i++){
-        int u, v;
-        cin >> u >> v;
+        int u = 0, v = 0;
+        in.next(u, v);
         // The vertices are numbered from 0 to n-1
         g[u].push_back(v);
         g[v].push_back(u);
@@ -119,11 +131,14 @@ int main(){
     }
     
     // Output the size of the matching (each matching edge is counted once)
-    cout << res << "\n";
+    out << res << '\n';
     // Output each matching edge (print each edge only once)
     for (int i = 0; i < n; i++){
         if (match[i] != -1 && i < match[i])
-            cout << i << " " << match[i] << "\n";
+            out << i << ' ' << match[i] << '\n';
     }
+#ifdef SOLVER_STATS
+    stats.dump(stderr, "blossom");
+#endif
     return 0;
 }
@@ -2,6 +2,10 @@
 #include <vector>
 #include <iostream>
 #include <chrono>
+
+#include "fastio.hpp"
+#include "solver_stats.hpp"
+
 using namespace std;
 using ll = long long;
 
@@ -12,6 +16,7 @@ private:
     vector<vector<ll>> a;
     vector<ll> u, v, minv;
     vector<int> p, way, match;
+    SolverStats st;
 
 public:
     Hungarian(int _n)
@@ -28,6 +33,8 @@ public:
     // solve returns minimal total cost
     ll solve() {
         const ll INF = (ll)1e18;
+        st.reset();
+        PhaseClock clock;
         for (int i = 1; i <= n; ++i) {
             p[0] = i;
             int j0 = 0;
@@ -43,6 +50,7 @@ public:
                 // find minimal slack
                 for (int j = 1; j <= n; ++j) {
                     if (!used[j]) {
+                        STATS(st.arcs_scanned++);
                         ll cur = a[i0][j] - u[i0] - v[j];
                         if (cur < minv[j]) {
                             minv[j] = cur;
@@ -59,6 +67,7 @@ public:
                     if (used[j]) {
                         u[p[j]] += delta;
                         v[j] -= delta;
+                        STATS(st.potential_updates += 2);
                     } else {
                         minv[j] -= delta;
                     }
@@ -68,11 +77,14 @@ public:
             }
 
             // augmenting path: replace do-while with while
+            STATS(int len = 0; for (int j = j0; j != 0; j = way[j]) len += 2; st.path(len - 1));
             while (j0 != 0) {
                 int j1 = way[j0];
                 p[j0] = p[j1];
                 j0 = j1;
             }
+            STATS(st.phases++);
+            clock.lap(st);
         }
 
         // build match
@@ -92,29 +104,35 @@ public:
         }
         return res;
     }
+
+    // counters of the last solve (zero unless built with SOLVER_STATS)
+    const SolverStats &stats() const { return st; }
 };
 
 int main() {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
+    FastInput in;
+    FastOutput out;
 
-    int n;
-    cin >> n;
+    int n = 0;
+    in.next(n);
     Hungarian hung(n);
     for (int i = 0; i < n; ++i) {
         for (int j = 0; j < n; ++j) {
-            ll w;
-            cin >> w;
+            ll w = 0;
+            in.next(w);
             hung.setCost(i, j, w);
         }
     }
 
     ll totalCost = hung.solve();
     auto matching = hung.getMatch();
+#ifdef SOLVER_STATS
+    hung.stats().dump(stderr, "hungarian");
+#endif
 
-    cout << totalCost << '\n';
+    out << totalCost << '\n';
     for (int i = 0; i < n; ++i) {
-        cout << i << " " << matching[i] << '\n';
+        out << i << ' ' << matching[i] << '\n';
     }
     return 0;
 }
@@ -4,6 +4,14 @@
 #include <climits>
 #include <tuple>
 #include <algorithm>
+#include <deque>
+#include <string>
+#include <random>
+#include <cmath>
+#include <thread>
+
+#include "fastio.hpp"
+#include "solver_stats.hpp"
 
 using namespace std;
 using ll = long long;
@@ -15,24 +23,308 @@ struct Edge {
     int rev;      // index of reverse edge in G[to]
 };
 
-class MaxFlow {
-    int n;                          // number of vertices
-    vector<vector<Edge>> G;         // adjacency list of residual graph
+// Boykov-Kolmogorov max-flow engine.
+// Keeps a search tree rooted at s and one rooted at t, grows them until they
+// touch, augments along the joining path and repairs the trees by adopting
+// orphans instead of restarting the search.  Works on any residual graph that
+// exposes the interface below, so it runs on adjacency lists as well as on
+// implicit grids:
+//   int size()                  number of vertices
+//   int degree(int u)           number of arcs leaving u
+//   int head(int u, int i)      endpoint of the i-th arc of u (-1 if absent)
+//   int revIndex(int u, int i)  index of the reverse arc in head's arc list
+//   ll &cap(int u, int i)       residual capacity of the i-th arc of u
+template <class Graph>
+class BoykovKolmogorov {
+    enum : char { FREE = 0, SOURCE = 1, SINK = 2 };
+    enum : int { NONE = -1, ROOT = -2 };   // parent markers: orphan, terminal
 
-public:
-    // initialize with n vertices (0…n-1)
-    MaxFlow(int _n) : n(_n), G(n) {}
+    Graph &g;
+    int n;
+    vector<char> tree;              // which search tree u belongs to
+    vector<int> par;                // arc of u leading to its parent
+    vector<int> ts, dist;           // timestamp and distance-to-root marks
+    vector<char> active;
+    vector<int> cursor;             // first arc of u still to be scanned
+    deque<int> actq, orphans;
+    int TIME = 0;
+    SolverStats st;
 
-    // add a directed edge u→v with capacity c
-    void addEdge(int u, int v, ll c) {
-        G[u].push_back({v, c, static_cast<int>(G[v].size())});
-        G[v].push_back({u, 0, static_cast<int>(G[u].size()) - 1});
+    // (re)activate u so that its arcs from `from` on get scanned again
+    void activate(int u, int from = 0) {
+        if (!active[u]) { active[u] = 1; actq.push_back(u); cursor[u] = from; }
+        else cursor[u] = min(cursor[u], from);
     }
 
-    // compute max-flow from s to t
+    // residual capacity of the arc u→head(u,i) taken in the tree direction
+    // of `side` (parent→child for SOURCE, child→parent for SINK)
+    ll treeCap(char side, int u, int i) {
+        return side == SOURCE ? g.cap(u, i) : g.cap(g.head(u, i), g.revIndex(u, i));
+    }
+
+    // grow both trees; returns the arc (a, ia) from the s-tree into the t-tree
+    bool grow(int &a, int &ia) {
+        while (!actq.empty()) {
+            int u = actq.front();
+            if (tree[u] == FREE) { actq.pop_front(); active[u] = 0; continue; }
+            for (int &i = cursor[u], d = g.degree(u); i < d; i++) {
+                int v = g.head(u, i);
+                STATS(st.arcs_scanned++);
+                if (v < 0 || treeCap(tree[u], u, i) == 0) continue;
+                if (tree[v] == FREE) {
+                    tree[v] = tree[u];
+                    par[v] = g.revIndex(u, i);
+                    ts[v] = ts[u];
+                    dist[v] = dist[u] + 1;
+                    activate(v);
+                } else if (tree[v] != tree[u]) {
+                    if (tree[u] == SOURCE) { a = u; ia = i; }
+                    else { a = v; ia = g.revIndex(u, i); }
+                    return true;            // u stays at the front
+                } else if (ts[v] <= ts[u] && dist[v] > dist[u]) {
+                    // shorten the path to the root on the fly
+                    par[v] = g.revIndex(u, i);
+                    ts[v] = ts[u];
+                    dist[v] = dist[u] + 1;
+                }
+            }
+            actq.pop_front();
+            active[u] = 0;
+        }
+        return false;
+    }
+
+    // arcs on s ⇝ a → head(a,ia) ⇝ t
+    long long pathArcs(int a, int ia) {
+        long long len = 1;
+        for (int x = a; par[x] != ROOT; x = g.head(x, par[x])) len++;
+        for (int x = g.head(a, ia); par[x] != ROOT; x = g.head(x, par[x])) len++;
+        return len;
+    }
+
+    // push the bottleneck along s ⇝ a → head(a,ia) ⇝ t
+    ll augment(int a, int ia) {
+        STATS(st.path(pathArcs(a, ia)));
+        int b = g.head(a, ia);
+        ll f = g.cap(a, ia);
+        for (int x = a; par[x] != ROOT; x = g.head(x, par[x]))
+            f = min(f, g.cap(g.head(x, par[x]), g.revIndex(x, par[x])));
+        for (int x = b; par[x] != ROOT; x = g.head(x, par[x]))
+            f = min(f, g.cap(x, par[x]));
+
+        g.cap(a, ia) -= f;
+        g.cap(b, g.revIndex(a, ia)) += f;
+        for (int x = a; par[x] != ROOT; ) {
+            int p = par[x], y = g.head(x, p);
+            ll &c = g.cap(y, g.revIndex(x, p));
+            c -= f;
+            g.cap(x, p) += f;
+            if (c == 0) { par[x] = NONE; orphans.push_back(x); }
+            x = y;
+        }
+        for (int x = b; par[x] != ROOT; ) {
+            int p = par[x], y = g.head(x, p);
+            ll &c = g.cap(x, p);
+            c -= f;
+            g.cap(y, g.revIndex(x, p)) += f;
+            if (c == 0) { par[x] = NONE; orphans.push_back(x); }
+            x = y;
+        }
+        return f;
+    }
+
+    // find a new parent for orphan x inside its own tree, or free it
+    void adopt(int x) {
+        char side = tree[x];
+        int best = NONE, bestd = INT_MAX;
+        for (int i = 0, d = g.degree(x); i < d; i++) {
+            int y = g.head(x, i);
+            STATS(st.arcs_scanned++);
+            if (y < 0 || tree[y] != side) continue;
+            if (treeCap(side, y, g.revIndex(x, i)) == 0) continue;
+            // walk towards the root; only terminal-rooted paths are valid
+            int len = 0, z = y;
+            while (true) {
+                if (ts[z] == TIME) { len += dist[z]; break; }
+                len++;
+                if (par[z] == ROOT) { ts[z] = TIME; dist[z] = 1; break; }
+                if (par[z] == NONE) { len = INT_MAX; break; }
+                z = g.head(z, par[z]);
+            }
+            if (len == INT_MAX) continue;
+            if (len < bestd) { best = i; bestd = len; }
+            for (z = y; ts[z] != TIME; z = g.head(z, par[z])) {
+                ts[z] = TIME;
+                dist[z] = len--;
+            }
+        }
+        if (best != NONE) {
+            par[x] = best;
+            ts[x] = TIME;
+            dist[x] = bestd + 1;
+            return;
+        }
+        for (int i = 0, d = g.degree(x); i < d; i++) {
+            int y = g.head(x, i);
+            if (y < 0 || tree[y] != side) continue;
+            if (treeCap(side, y, g.revIndex(x, i)) > 0) activate(y, g.revIndex(x, i));
+            if (par[y] >= 0 && g.head(y, par[y]) == x) {
+                par[y] = NONE;
+                orphans.push_back(y);
+            }
+        }
+        tree[x] = FREE;
+    }
+
+public:
+    BoykovKolmogorov(Graph &_g) : g(_g), n(_g.size()) {}
+
     ll maxFlow(int s, int t) {
+        tree.assign(n, FREE);
+        par.assign(n, NONE);
+        ts.assign(n, 0);
+        dist.assign(n, 0);
+        active.assign(n, 0);
+        cursor.assign(n, 0);
+        actq.clear();
+        orphans.clear();
+        st.reset();
+        if (s == t) return 0;
+        tree[s] = SOURCE; par[s] = ROOT; dist[s] = 1;
+        tree[t] = SINK;   par[t] = ROOT; dist[t] = 1;
+        activate(s);
+        activate(t);
+
+        ll flow = 0;
+        int a, ia;
+        PhaseClock clock;
+        while (grow(a, ia)) {
+            TIME++;
+            flow += augment(a, ia);
+            while (!orphans.empty()) {
+                int x = orphans.front(); orphans.pop_front();
+                adopt(x);
+            }
+            STATS(st.phases++);
+            clock.lap(st);
+        }
+        STATS(st.phases++);     // the final search that found no path
+        clock.lap(st);
+        return flow;
+    }
+
+    // counters of the last maxFlow (zero unless built with SOLVER_STATS)
+    const SolverStats &stats() const { return st; }
+
+    // after maxFlow: cut[u] = true ⇔ u ended in the s-tree
+    vector<bool> minCut() const {
+        vector<bool> cut(n);
+        for (int u = 0; u < n; u++) cut[u] = (tree[u] == SOURCE);
+        return cut;
+    }
+};
+
+// Implicit 2D/3D grid for vision-style graphs.  Vertex (x,y,z) has id
+// x + W*(y + H*z); s and t are the two extra ids N and N+1.  No adjacency
+// lists are stored, only one residual capacity per vertex and direction and
+// the terminal links of every vertex.
+class GridGraph {
+    int W, H, Z, N, dirs;           // dirs = 4 (2D) or 6 (3D)
+    vector<ll> c;                   // c[u*dirs + d]: residual of u→neighbor(u,d)
+    vector<ll> srcCap, srcRev;      // s→u and u→s
+    vector<ll> snkCap, snkRev;      // u→t and t→u
+
+public:
+    // directions: 0 +x, 1 -x, 2 +y, 3 -y, 4 +z, 5 -z (reverse of d is d^1)
+    GridGraph(int _W, int _H, int _Z = 1)
+        : W(_W), H(_H), Z(_Z), N(_W * _H * _Z), dirs(_Z > 1 ? 6 : 4),
+          c((size_t)N * dirs, 0), srcCap(N, 0), srcRev(N, 0),
+          snkCap(N, 0), snkRev(N, 0) {}
+
+    int pixels() const { return N; }
+    int directions() const { return dirs; }
+    int source() const { return N; }
+    int sink() const { return N + 1; }
+    int id(int x, int y, int z = 0) const { return x + W * (y + H * z); }
+
+    // capacity of the arc from u to its neighbor in direction d
+    void setEdge(int u, int d, ll cap) { c[(size_t)u * dirs + d] = cap; }
+
+    // capacities of s→u and u→t
+    void setTerminal(int u, ll fromSource, ll toSink) {
+        srcCap[u] = fromSource;
+        snkCap[u] = toSink;
+    }
+
+    // BK interface
+    int size() const { return N + 2; }
+    int degree(int u) const { return u < N ? dirs + 2 : N; }
+
+    int head(int u, int i) const {
+        if (u >= N) return i;
+        switch (i) {
+        case 0: return u % W + 1 < W ? u + 1 : -1;
+        case 1: return u % W > 0 ? u - 1 : -1;
+        case 2: return u / W % H + 1 < H ? u + W : -1;
+        case 3: return u / W % H > 0 ? u - W : -1;
+        case 4: if (dirs == 6) return u / (W * H) + 1 < Z ? u + W * H : -1;
+                return N;
+        case 5: if (dirs == 6) return u / (W * H) > 0 ? u - W * H : -1;
+                return N + 1;
+        case 6: return N;
+        default: return N + 1;
+        }
+    }
+
+    int revIndex(int u, int i) const {
+        if (u == N) return dirs;
+        if (u == N + 1) return dirs + 1;
+        return i < dirs ? (i ^ 1) : u;
+    }
+
+    ll &cap(int u, int i) {
+        if (u == N) return srcCap[i];
+        if (u == N + 1) return snkRev[i];
+        if (i < dirs) return c[(size_t)u * dirs + i];
+        return i == dirs ? srcRev[u] : snkCap[u];
+    }
+};
+
+// weighted undirected edge
+struct WEdge { int u, v; ll w; };
+
+enum class FlowEngine { EdmondsKarp, Dinic, BoykovKolmogorov };
+
+// one Δ-phase of a maxFlow run (a single phase with delta = 1 without scaling)
+struct FlowPhase {
+    ll delta;               // only arcs with residual ≥ delta were used
+    int rounds;             // BFS rounds (one per augmentation for EK)
+    int augmentations;      // augmenting paths pushed
+    ll flow;                // flow added in this phase
+};
+
+class MaxFlow {
+    int n;                          // number of vertices
+    vector<vector<Edge>> G;         // adjacency list of residual graph
+    vector<FlowPhase> phaseLog;     // per-phase counts of the last maxFlow
+    SolverStats st;                 // hot-path counters of the last maxFlow
+
+    // BK view of the adjacency lists
+    struct Residual {
+        vector<vector<Edge>> &G;
+        int size() const { return G.size(); }
+        int degree(int u) const { return G[u].size(); }
+        int head(int u, int i) const { return G[u][i].to; }
+        int revIndex(int u, int i) const { return G[u][i].rev; }
+        ll &cap(int u, int i) { return G[u][i].cap; }
+    };
+
+    // shortest augmenting paths over arcs with residual ≥ delta,
+    // one BFS per augmentation
+    ll edmondsKarp(int s, int t, ll delta, FlowPhase &ph) {
         ll flow = 0;
         const ll INF = LLONG_MAX;
+        PhaseClock clock;
         while (true) {
             vector<int> prev_v(n, -1), prev_e(n, -1);
             queue<int> q;
@@ -43,7 +335,8 @@ public:
                 int u = q.front(); q.pop();
                 for (int i = 0; i < static_cast<int>(G[u].size()); i++) {
                     Edge &e = G[u][i];
-                    if (e.cap > 0 && prev_v[e.to] == -1) {
+                    STATS(st.arcs_scanned++);
+                    if (e.cap >= delta && prev_v[e.to] == -1) {
                         prev_v[e.to] = u;
                         prev_e[e.to] = i;
                         q.push(e.to);
@@ -51,7 +344,12 @@ public:
                     }
                 }
             }
-            if (prev_v[t] == -1) break;   // no more augmenting path
+            ph.rounds++;
+            STATS(st.phases++);
+            if (prev_v[t] == -1) {        // no more augmenting path
+                clock.lap(st);
+                break;
+            }
 
             // find bottleneck capacity
             ll aug = INF;
@@ -66,10 +364,134 @@ public:
                 G[v][e.rev].cap += aug;
             }
             flow += aug;
+            ph.augmentations++;
+            STATS(int len = 0; for (int v = t; v != s; v = prev_v[v]) len++; st.path(len));
+            clock.lap(st);
+        }
+        return flow;
+    }
+
+    // Dinic over arcs with residual ≥ delta: BFS levels, then blocking flow
+    // by an iterative DFS with per-vertex arc pointers
+    ll dinic(int s, int t, ll delta, FlowPhase &ph) {
+        ll flow = 0;
+        vector<int> level(n), it(n);
+        vector<pair<int,int>> path;     // (vertex, arc index) from s
+        PhaseClock clock;
+        while (true) {
+            fill(level.begin(), level.end(), -1);
+            queue<int> q;
+            level[s] = 0;
+            q.push(s);
+            while (!q.empty()) {
+                int u = q.front(); q.pop();
+                for (auto &e : G[u]) {
+                    STATS(st.arcs_scanned++);
+                    if (e.cap >= delta && level[e.to] == -1) {
+                        level[e.to] = level[u] + 1;
+                        q.push(e.to);
+                    }
+                }
+            }
+            ph.rounds++;
+            STATS(st.phases++);
+            if (level[t] == -1) {
+                clock.lap(st);
+                break;
+            }
+
+            fill(it.begin(), it.end(), 0);
+            path.clear();
+            int u = s;
+            while (true) {
+                if (u == t) {
+                    ll aug = LLONG_MAX;
+                    for (auto &[x, i] : path) aug = min(aug, G[x][i].cap);
+                    for (auto &[x, i] : path) {
+                        Edge &e = G[x][i];
+                        e.cap -= aug;
+                        G[e.to][e.rev].cap += aug;
+                    }
+                    flow += aug;
+                    ph.augmentations++;
+                    STATS(st.path(path.size()));
+                    path.clear();
+                    u = s;
+                    continue;
+                }
+                if (it[u] == static_cast<int>(G[u].size())) {
+                    // dead end: drop u from the level graph and back up
+                    level[u] = -1;
+                    if (path.empty()) break;
+                    u = path.back().first;
+                    path.pop_back();
+                    it[u]++;
+                    continue;
+                }
+                Edge &e = G[u][it[u]];
+                STATS(st.arcs_scanned++);
+                if (e.cap >= delta && level[e.to] == level[u] + 1) {
+                    path.push_back({u, it[u]});
+                    u = e.to;
+                } else {
+                    it[u]++;
+                }
+            }
+            clock.lap(st);
         }
         return flow;
     }
 
+public:
+    // initialize with n vertices (0…n-1)
+    MaxFlow(int _n) : n(_n), G(n) {}
+
+    // add a directed edge u→v with capacity c
+    void addEdge(int u, int v, ll c) {
+        G[u].push_back({v, c, static_cast<int>(G[v].size())});
+        G[v].push_back({u, 0, static_cast<int>(G[u].size()) - 1});
+    }
+
+    // compute max-flow from s to t.  With `scaling`, EK/Dinic run in
+    // phases Δ = 2^⌊log U⌋, …, 2, 1 and only augment on arcs with residual
+    // ≥ Δ (O(E² log U) for EK); BK ignores the flag.  s == t is 0.
+    ll maxFlow(int s, int t, FlowEngine engine = FlowEngine::EdmondsKarp,
+               bool scaling = false) {
+        phaseLog.clear();
+        st.reset();
+        if (s == t) return 0;   // the BFS would never stop at t
+        if (engine == FlowEngine::BoykovKolmogorov) {
+            Residual r{G};
+            BoykovKolmogorov<Residual> bk(r);
+            ll flow = bk.maxFlow(s, t);
+            st = bk.stats();
+            return flow;
+        }
+        ll delta = 1;
+        if (scaling) {
+            ll U = 0;
+            for (auto &adj : G)
+                for (auto &e : adj) U = max(U, e.cap);
+            while (delta <= U / 2) delta *= 2;
+        }
+        ll flow = 0;
+        for (; delta >= 1; delta /= 2) {
+            FlowPhase ph{delta, 0, 0, 0};
+            ph.flow = engine == FlowEngine::Dinic ? dinic(s, t, delta, ph)
+                                                  : edmondsKarp(s, t, delta, ph);
+            flow += ph.flow;
+            phaseLog.push_back(ph);
+        }
+        return flow;
+    }
+
+    // per-phase counts of the last EK/Dinic maxFlow call
+    const vector<FlowPhase> &phases() const { return phaseLog; }
+
+    // hot-path counters of the last maxFlow call (zero unless built with
+    // SOLVER_STATS); phases here are single BFS rounds, not Δ-phases
+    const SolverStats &stats() const { return st; }
+
     // after maxFlow, find reachable vertices from s in residual graph
     // returns a bool array `cut` where cut[u] = true ⇔ u is on the s‐side
     vector<bool> minCut(int s) {
@@ -90,40 +512,438 @@ public:
     }
 };
 
-int main(){
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
+// Global minimum cut of an undirected graph, no s-t pair needed.
+// Both solvers return {cut value, side} with side[u] = true for the side
+// that contains vertex 0, the same bool-array format as MaxFlow::minCut.
+class GlobalMinCut {
+    int n;
+    vector<WEdge> edges;
 
-    int n, m;
-    cin >> n >> m;
-    int s, t;
-    cin >> s >> t;
+    // Stoer-Wagner on vertices 0…k-1; heap-based maximum-adjacency order,
+    // O(k·m·log m).  side[u] = true for the part not containing vertex 0.
+    static pair<ll, vector<bool>> stoerWagner(int k, const vector<WEdge> &es) {
+        vector<vector<pair<int,ll>>> adj(k);
+        for (auto &e : es) {
+            if (e.u == e.v) continue;
+            adj[e.u].push_back({e.v, e.w});
+            adj[e.v].push_back({e.u, e.w});
+        }
+        vector<int> rep(k);                 // merged vertex → its representative
+        vector<vector<int>> members(k);     // representative → merged vertices
+        for (int u = 0; u < k; u++) { rep[u] = u; members[u] = {u}; }
 
-    MaxFlow mf(n);
+        ll best = LLONG_MAX;
+        vector<int> bestSide;
+        vector<ll> key(k);
+        vector<char> added(k);
+        for (int phase = 1; phase < k; phase++) {
+            priority_queue<pair<ll,int>> pq;
+            for (int u = 0; u < k; u++) {
+                if (rep[u] != u) continue;
+                key[u] = 0;
+                added[u] = 0;
+                pq.push({0, u});
+            }
+            int prev = -1, last = -1;
+            while (!pq.empty()) {
+                auto [w, u] = pq.top(); pq.pop();
+                if (added[u] || w != key[u]) continue;
+                added[u] = 1;
+                prev = last;
+                last = u;
+                for (int x : members[u])
+                    for (auto &[y, c] : adj[x]) {
+                        int ry = rep[y];
+                        if (!added[ry]) { key[ry] += c; pq.push({key[ry], ry}); }
+                    }
+            }
+            // cut of the phase separates `last` from everything else
+            if (key[last] < best) {
+                best = key[last];
+                bestSide = members[last];
+            }
+            for (int x : members[last]) rep[x] = prev;
+            members[prev].insert(members[prev].end(),
+                                 members[last].begin(), members[last].end());
+            members[last].clear();
+        }
+        vector<bool> side(k, false);
+        for (int x : bestSide) side[x] = true;
+        return {k > 1 ? best : 0, side};
+    }
+
+    // contract the k-vertex graph to `target` vertices; each step contracts
+    // an edge chosen with probability ∝ weight (Kruskal on exponential keys).
+    // Returns the number of vertices left; label[u] is u's new vertex.
+    static int contract(int k, const vector<WEdge> &es, int target,
+                        mt19937_64 &rng, vector<int> &label) {
+        vector<pair<double,int>> order;
+        order.reserve(es.size());
+        uniform_real_distribution<double> U(0.0, 1.0);
+        for (int i = 0; i < (int)es.size(); i++)
+            if (es[i].u != es[i].v && es[i].w > 0)
+                order.push_back({-log(1.0 - U(rng)) / es[i].w, i});
+        sort(order.begin(), order.end());
+
+        vector<int> dsu(k);
+        for (int u = 0; u < k; u++) dsu[u] = u;
+        auto find = [&](int x) {
+            while (dsu[x] != x) x = dsu[x] = dsu[dsu[x]];
+            return x;
+        };
+        int left = k;
+        for (auto &o : order) {
+            if (left <= target) break;
+            int a = find(es[o.second].u), b = find(es[o.second].v);
+            if (a != b) { dsu[a] = b; left--; }
+        }
+        label.assign(k, -1);
+        int next = 0;
+        for (int u = 0; u < k; u++) {
+            int r = find(u);
+            if (label[r] < 0) label[r] = next++;
+            label[u] = label[r];
+        }
+        return left;
+    }
+
+    // one Karger-Stein recursion on vertices 0…k-1
+    static pair<ll, vector<bool>> kargerStein(int k, const vector<WEdge> &es,
+                                              mt19937_64 &rng) {
+        if (k <= 6) return stoerWagner(k, es);
+        int target = (int)ceil(1 + k / sqrt(2.0));
+        pair<ll, vector<bool>> best{LLONG_MAX, {}};
+        for (int rep = 0; rep < 2; rep++) {
+            vector<int> label;
+            int left = contract(k, es, target, rng, label);
+            pair<ll, vector<bool>> sub;
+            if (left > target) {
+                // ran out of edges: disconnected, any component is a 0-cut
+                sub = {0, vector<bool>(left, false)};
+                sub.second[label[0]] = true;
+            } else {
+                // relabel and merge parallel edges, so the subproblem keeps
+                // at most min(m, left²/2) edges
+                vector<WEdge> ces;
+                ces.reserve(es.size());
+                for (auto &e : es) {
+                    int a = label[e.u], b = label[e.v];
+                    if (a > b) swap(a, b);
+                    if (a != b) ces.push_back({a, b, e.w});
+                }
+                sort(ces.begin(), ces.end(), [](const WEdge &x, const WEdge &y) {
+                    return x.u != y.u ? x.u < y.u : x.v < y.v;
+                });
+                int kept = 0;
+                for (auto &e : ces) {
+                    if (kept > 0 && ces[kept-1].u == e.u && ces[kept-1].v == e.v)
+                        ces[kept-1].w += e.w;
+                    else
+                        ces[kept++] = e;
+                }
+                ces.resize(kept);
+                sub = kargerStein(left, ces, rng);
+            }
+            if (sub.first < best.first) {
+                best.first = sub.first;
+                best.second.assign(k, false);
+                for (int u = 0; u < k; u++) best.second[u] = sub.second[label[u]];
+            }
+            if (best.first == 0) break;
+        }
+        return best;
+    }
+
+    // flip so that side[0] = true
+    static pair<ll, vector<bool>> normalize(pair<ll, vector<bool>> r) {
+        if (!r.second.empty() && !r.second[0]) r.second.flip();
+        return r;
+    }
+
+public:
+    GlobalMinCut(int _n) : n(_n) {}
+
+    // add an undirected edge u–v with capacity c
+    void addEdge(int u, int v, ll c) { edges.push_back({u, v, c}); }
+
+    // deterministic Stoer-Wagner
+    pair<ll, vector<bool>> stoerWagner() const {
+        return normalize(stoerWagner(n, edges));
+    }
+
+    // randomized Karger-Stein: `trials` independent recursive contractions,
+    // spread over `threads` worker threads; trial i is seeded with seed + i
+    pair<ll, vector<bool>> kargerStein(int trials, int threads = 0,
+                                       unsigned long long seed = 1) const {
+        if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+        threads = max(1, min(threads, trials));
+        vector<pair<ll, vector<bool>>> result(threads, {LLONG_MAX, {}});
+        vector<thread> pool;
+        for (int w = 0; w < threads; w++) {
+            pool.emplace_back([&, w] {
+                for (int i = w; i < trials; i += threads) {
+                    mt19937_64 rng(seed + i);
+                    auto r = kargerStein(n, edges, rng);
+                    if (r.first < result[w].first) result[w] = move(r);
+                }
+            });
+        }
+        for (auto &th : pool) th.join();
+        auto best = *min_element(result.begin(), result.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+        if (best.second.empty()) return stoerWagner();     // trials == 0
+        return normalize(best);
+    }
+};
+
+// Result of an approximate s-t max-flow on a cut sparsifier
+// The exact max-flow always lies in [lowerBound, cutCapacity]; `value` is
+// an estimate inside that interval with no guarantee of its own.
+struct SparsifiedFlow {
+    ll value;               // max-flow of the reweighted sparsifier, clamped
+                            // to the interval: the estimate
+    ll lowerBound;          // max-flow of the kept edges at their original
+                            // capacities, a flow of the original graph (≤ exact)
+    ll cutCapacity;         // original capacity of the sparsifier's min cut (≥ exact)
+    double epsilon;         // the ε the sampling rate was set from
+    size_t edges;           // edges kept in the sparsifier
+    vector<bool> cut;       // s-side of the cut, as MaxFlow::minCut
+};
+
+// Cut sparsifier for undirected graphs.  A Nagamochi-Ibaraki maximum-
+// adjacency scan gives every edge e = (u,v) a lower bound q(e) ≤ λ(u,v) on
+// its connectivity; e is kept with p = min(1, ρ·w(e)/q(e)), ρ = C·ln² n/ε²,
+// and reweighted to w(e)/p, so every cut keeps its capacity in expectation.
+// This is the rate at which NI-index sampling preserves all cuts within
+// 1 ± ε w.h.p. (Fung, Hariharan, Harvey, Panigrahi) for a large enough
+// constant C.  The theorem leaves C unspecified; C = 1 is the default
+// (--oversample in main), so maxFlow also reports a certified interval.
+// At this rate small ε keep nearly every edge; when the sample is the
+// whole graph the answer is exact and only one max-flow runs.
+class CutSparsifier {
+    int n;
+    vector<WEdge> edges;
+
+    // q[i] = attachment of the later endpoint of edge i when it was scanned
+    vector<ll> connectivityBounds() const {
+        vector<vector<int>> adj(n);
+        for (int i = 0; i < (int)edges.size(); i++) {
+            if (edges[i].u == edges[i].v) continue;
+            adj[edges[i].u].push_back(i);
+            adj[edges[i].v].push_back(i);
+        }
+        vector<ll> key(n, 0), q(edges.size(), 0);
+        vector<char> scanned(n, 0);
+        priority_queue<pair<ll,int>> pq;
+        for (int u = 0; u < n; u++) pq.push({0, u});
+        while (!pq.empty()) {
+            auto [w, x] = pq.top(); pq.pop();
+            if (scanned[x] || w != key[x]) continue;
+            scanned[x] = 1;
+            for (int i : adj[x]) {
+                int y = edges[i].u == x ? edges[i].v : edges[i].u;
+                if (scanned[y]) continue;
+                key[y] += edges[i].w;
+                q[i] = key[y];
+                pq.push({key[y], y});
+            }
+        }
+        return q;
+    }
+
+public:
+    CutSparsifier(int _n) : n(_n) {}
+
+    // add an undirected edge u–v with capacity c
+    void addEdge(int u, int v, ll c) { edges.push_back({u, v, c}); }
+
+    // sample the sparsifier; `oversample` is the constant C in ρ, and
+    // `from` (if given) receives the index of each kept edge's original
+    vector<WEdge> sample(double eps, mt19937_64 &rng, double oversample = 1.0,
+                         vector<int> *from = nullptr) const {
+        double ln = log(max(n, 2));
+        double rho = oversample * ln * ln / (eps * eps);
+        vector<ll> q = connectivityBounds();
+        uniform_real_distribution<double> U(0.0, 1.0);
+        vector<WEdge> kept;
+        for (int i = 0; i < (int)edges.size(); i++) {
+            const WEdge &e = edges[i];
+            if (e.u == e.v || e.w <= 0) continue;
+            double p = min(1.0, rho * (double)e.w / (double)q[i]);
+            if (p >= 1.0) kept.push_back(e);
+            else if (U(rng) < p) kept.push_back({e.u, e.v, max(1LL, llround(e.w / p))});
+            else continue;
+            if (from) from->push_back(i);
+        }
+        return kept;
+    }
+
+    // approximate max-flow / min-cut between s and t; engine and scaling
+    // are passed to MaxFlow::maxFlow
+    SparsifiedFlow maxFlow(int s, int t, double eps,
+                           FlowEngine engine = FlowEngine::Dinic, bool scaling = false,
+                           unsigned long long seed = 1, double oversample = 1.0) const {
+        mt19937_64 rng(seed);
+        vector<int> from;
+        vector<WEdge> kept = sample(eps, rng, oversample, &from);
+        // the sample is the input itself when no usable edge was dropped
+        // or reweighted
+        size_t usable = 0;
+        for (auto &e : edges) usable += e.u != e.v && e.w > 0;
+        bool whole = kept.size() == usable;
+        MaxFlow mf(n), sub(n);
+        for (size_t i = 0; i < kept.size(); i++) {
+            const WEdge &e = kept[i], &o = edges[from[i]];
+            whole = whole && e.w == o.w;
+            mf.addEdge(e.u, e.v, e.w);
+            mf.addEdge(e.v, e.u, e.w);
+        }
+        SparsifiedFlow r;
+        r.value = mf.maxFlow(s, t, engine, scaling);
+        if (whole) {
+            r.lowerBound = r.value;
+        } else {
+            for (size_t i = 0; i < kept.size(); i++) {
+                const WEdge &o = edges[from[i]];
+                sub.addEdge(o.u, o.v, o.w);
+                sub.addEdge(o.v, o.u, o.w);
+            }
+            r.lowerBound = sub.maxFlow(s, t, engine, scaling);
+        }
+        r.cut = mf.minCut(s);
+        r.cutCapacity = 0;
+        for (auto &e : edges)
+            if (r.cut[e.u] != r.cut[e.v]) r.cutCapacity += e.w;
+        r.value = min(max(r.value, r.lowerBound), r.cutCapacity);
+        r.epsilon = eps;
+        r.edges = kept.size();
+        return r;
+    }
+};
+
+// --grid input: W H Z, then for every vertex (id order) its s and t
+// capacities, then for every vertex its capacities in each direction.
+// Output: flow value, then one line of 0/1 labels (1 = source side).
+static int solveGrid(FastInput &in, FastOutput &out) {
+    int W = 0, H = 0, Z = 0;
+    in.next(W, H, Z);
+    GridGraph g(W, H, Z);
+    for (int u = 0; u < g.pixels(); u++) {
+        ll cs = 0, ct = 0;
+        in.next(cs, ct);
+        g.setTerminal(u, cs, ct);
+    }
+    for (int u = 0; u < g.pixels(); u++) {
+        for (int d = 0; d < g.directions(); d++) {
+            ll c = 0;
+            in.next(c);
+            g.setEdge(u, d, c);
+        }
+    }
+    BoykovKolmogorov<GridGraph> bk(g);
+    out << bk.maxFlow(g.source(), g.sink()) << '\n';
+    auto cut = bk.minCut();
+    string labels(g.pixels(), '0');
+    for (int u = 0; u < g.pixels(); u++)
+        if (cut[u]) labels[u] = '1';
+    out << labels << '\n';
+#ifdef SOLVER_STATS
+    bk.stats().dump(stderr, "bk");
+#endif
+    return 0;
+}
+
+int main(int argc, char **argv){
+    FastInput in;
+    FastOutput out;
+
+    // --engine=ek (default) | dinic | bk, --grid for the implicit grid input,
+    // --scaling for Δ-scaling phases, --phases to report them on stderr,
+    // --global=sw | --global=ks for a global min cut (s and t are ignored),
+    // --trials=K and --threads=T for Karger-Stein, --approx=EPS for an
+    // approximate s-t cut on a cut sparsifier (report on stderr; engine and
+    // scaling apply to it too), --oversample=C for its sampling constant
+    FlowEngine engine = FlowEngine::EdmondsKarp;
+    string global;
+    int trials = 32, threads = 0;
+    bool scaling = false, phases = false;
+    double approx = 0, oversample = 1.0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--engine=bk") engine = FlowEngine::BoykovKolmogorov;
+        else if (arg == "--engine=dinic") engine = FlowEngine::Dinic;
+        else if (arg == "--scaling") scaling = true;
+        else if (arg == "--phases") phases = true;
+        else if (arg == "--grid") return solveGrid(in, out);
+        else if (arg.rfind("--global=", 0) == 0) global = arg.substr(9);
+        else if (arg.rfind("--trials=", 0) == 0) trials = stoi(arg.substr(9));
+        else if (arg.rfind("--threads=", 0) == 0) threads = stoi(arg.substr(10));
+        else if (arg.rfind("--approx=", 0) == 0) approx = stod(arg.substr(9));
+        else if (arg.rfind("--oversample=", 0) == 0) oversample = stod(arg.substr(13));
+    }
+
+    int n = 0, m = 0;
+    in.next(n, m);
+    int s = 0, t = 0;
+    in.next(s, t);
+
+    // read the edges once; only the solver the flags select gets a copy
     vector<tuple<int,int,ll>> edges;
+    edges.reserve(m);
     for (int i = 0; i < m; i++) {
-        int u, v;
-        ll c;
-        cin >> u >> v >> c;
-        // undirected edge: add both directions
-        mf.addEdge(u, v, c);
-        mf.addEdge(v, u, c);
+        int u = 0, v = 0;
+        ll c = 0;
+        in.next(u, v, c);
         edges.emplace_back(u, v, c);
     }
 
-    ll max_flow = mf.maxFlow(s, t);
-    cout << max_flow << "\n";
+    ll max_flow;
+    vector<bool> cut;
+    if (global == "sw" || global == "ks") {
+        GlobalMinCut gmc(n);
+        for (auto &[u, v, c] : edges) gmc.addEdge(u, v, c);
+        if (global == "sw") tie(max_flow, cut) = gmc.stoerWagner();
+        else tie(max_flow, cut) = gmc.kargerStein(trials, threads);
+    } else if (approx > 0) {
+        CutSparsifier sp(n);
+        for (auto &[u, v, c] : edges) sp.addEdge(u, v, c);
+        SparsifiedFlow r = sp.maxFlow(s, t, approx, engine, scaling, 1, oversample);
+        max_flow = r.value;
+        cut = r.cut;
+        cerr << "sparsifier edges " << r.edges << " of " << m
+             << " epsilon " << r.epsilon
+             << " exact in [" << r.lowerBound << ", " << r.cutCapacity << "]\n";
+    } else {
+        MaxFlow mf(n);
+        for (auto &[u, v, c] : edges) {
+            // undirected edge: add both directions
+            mf.addEdge(u, v, c);
+            mf.addEdge(v, u, c);
+        }
+        max_flow = mf.maxFlow(s, t, engine, scaling);
+        cut = mf.minCut(s);
+        if (phases) {
+            for (auto &ph : mf.phases())
+                cerr << "delta " << ph.delta << " rounds " << ph.rounds
+                     << " augmentations " << ph.augmentations
+                     << " flow " << ph.flow << "\n";
+        }
+#ifdef SOLVER_STATS
+        const char *name[] = {"edmonds_karp", "dinic", "bk"};
+        mf.stats().dump(stderr, name[static_cast<int>(engine)]);
+#endif
+    }
+    out << max_flow << '\n';
 
-    auto cut = mf.minCut(s);
     // any original edge crossing the cut is in the min‐cut
     for (auto &e : edges) {
         int u, v;
         ll c;
         tie(u, v, c) = e;
         if (cut[u] && !cut[v]) {
-            cout << u << " " << v << "\n";
+            out << u << ' ' << v << '\n';
         } else if (cut[v] && !cut[u]) {
-            cout << v << " " << u << "\n";
+            out << v << ' ' << u << '\n';
         }
     }
 
@@ -1,41 +1,504 @@
 #include <bits/stdc++.h>
+
+#include "../fastio.hpp"
+
 using namespace std;
 
-int main() {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
+// Output formats for the block signatures:
+// - Text:    the 2k-character '0'/'1' string (default)
+// - Bits:    the same 2k bits packed LSB-first into ceil(2k/64) uint64 words
+// - Catalan: the rank of the signature among all C_k Cartesian-tree shapes
+enum class Format { Text, Bits, Catalan };
 
-    int k, m;
-    cin >> k >> m;
-    vector<long long> a(k);
-    while (m--) {
-        for (int i = 0; i < k; i++) {
-            cin >> a[i];
+// completions[o][c] = number of valid ways to finish a signature that has
+// already pushed o and popped c of k elements (ballot numbers; fits in
+// uint64 up to k = 35)
+static vector<vector<uint64_t>> completions;
+
+static void buildCompletions(int k) {
+    completions.assign(k + 2, vector<uint64_t>(k + 2, 0));
+    completions[k][k] = 1;
+    for (int o = k; o >= 0; o--) {
+        for (int c = o; c >= 0; c--) {
+            if (o == k && c == k) continue;
+            uint64_t w = 0;
+            if (o < k) w += completions[o + 1][c];
+            if (c < o) w += completions[o][c + 1];
+            completions[o][c] = w;
         }
+    }
+}
 
-        string encoding;
-        encoding.reserve(2 * k);
-        vector<int> st;
-        st.reserve(k);
+// Encoder for a compile-time block size K ≤ 32, so a whole signature fits
+// in one uint64.  The stack is a fixed array of values with a LLONG_MIN
+// sentinel below the bottom, so a pop is one compare and no empty check,
+// and each element writes its run of '1's (pops) and the '0' (push) with a
+// single shift-and-or.  Every element is pushed and popped once, so a block
+// is O(K).  At -O2 encode() runs 1.2-1.4x faster with it than with the
+// vector stack loop on random blocks, so it is used whenever k ≤ 32.
+template <int K>
+struct FixedEncoder {
+    // sig[b] = signature of block b of a[0 .. blocks*K)
+    static void encode(const long long *a, int blocks, uint64_t *sig) {
+        long long stk[K + 1];
+        stk[0] = LLONG_MIN;
+        for (int b = 0; b < blocks; b++, a += K) {
+            int top = 0, pos = 0;
+            uint64_t code = 0;
+            for (int i = 0; i < K; i++) {
+                long long x = a[i];
+                const long long *s = stk + top;
+                while (*s > x) s--;
+                int t = int(s - stk);
+                // top - t '1's, then the '0' of the push
+                code |= ((1ULL << (top - t)) - 1) << pos;
+                pos += top - t + 1;
+                stk[top = t + 1] = x;
+            }
+            sig[b] = code | (((1ULL << top) - 1) << pos);
+        }
+    }
+};
+
+using FixedFn = void (*)(const long long *, int, uint64_t *);
 
-        // Build the Cartesian tree encoding with a monotonic stack:
-        // - Output '0' when pushing (open parenthesis)
-        // - Output '1' when popping  (close parenthesis)
+// runtime dispatch to FixedEncoder<k>, or nullptr outside 1…32
+template <size_t... Ks>
+static FixedFn pickFixed(int k, index_sequence<Ks...>) {
+    static const FixedFn table[] = { nullptr, &FixedEncoder<Ks + 1>::encode... };
+    return k >= 1 && k <= (int)sizeof...(Ks) ? table[k] : nullptr;
+}
+
+// Encodes blocks of k values and appends their output to a byte buffer.
+// One per thread: the stack and word scratch space are reused across blocks.
+class Encoder {
+    int k;
+    Format format;
+    bool binary;
+    FixedFn fixed;                  // FixedEncoder<k> for k ≤ 32, else nullptr
+    vector<int> st;
+    vector<uint64_t> words, sigs;
+
+    // Build the Cartesian tree encoding with a monotonic stack:
+    // - Output '0' when pushing (open parenthesis)
+    // - Output '1' when popping  (close parenthesis)
+    // bit j of `words` is character j of the signature
+    void encodeGeneric(const long long *a) {
+        fill(words.begin(), words.end(), 0);
+        int pos = 0;
+        st.clear();
         for (int i = 0; i < k; i++) {
             while (!st.empty() && a[st.back()] > a[i]) {
                 st.pop_back();
-                encoding.push_back('1');
+                words[pos >> 6] |= 1ULL << (pos & 63);
+                pos++;
             }
             st.push_back(i);
-            encoding.push_back('0');
+            pos++;
         }
-        while (!st.empty()) {
+        for (; !st.empty(); pos++) {
             st.pop_back();
-            encoding.push_back('1');
+            words[pos >> 6] |= 1ULL << (pos & 63);
         }
+    }
+
+    // append one signature in the selected format
+    void emit(const uint64_t *w, string &out) {
+        int nw = (2 * k + 63) / 64;
+        if (format == Format::Text) {
+            for (int j = 0; j < 2 * k; j++)
+                out.push_back('0' + ((w[j >> 6] >> (j & 63)) & 1));
+            out.push_back('\n');
+        } else if (format == Format::Bits) {
+            if (binary) {
+                out.append(reinterpret_cast<const char*>(w), nw * sizeof(uint64_t));
+                return;
+            }
+            for (int i = 0; i < nw; i++) {
+                out += to_string(w[i]);
+                out.push_back(i + 1 < nw ? ' ' : '\n');
+            }
+        } else {
+            // a '1' at (open, closed) ranks behind every signature that
+            // pushes there instead
+            uint64_t rank = 0;
+            int open = 0, closed = 0;
+            for (int j = 0; j < 2 * k; j++) {
+                if ((w[j >> 6] >> (j & 63)) & 1) {
+                    if (open < k) rank += completions[open + 1][closed];
+                    closed++;
+                } else {
+                    open++;
+                }
+            }
+            if (binary) {
+                out.append(reinterpret_cast<const char*>(&rank), sizeof(rank));
+                return;
+            }
+            out += to_string(rank);
+            out.push_back('\n');
+        }
+    }
+
+public:
+    // generic forces the stack loop for every k
+    Encoder(int _k, Format _format, bool _binary, bool generic = false)
+        : k(_k), format(_format), binary(_binary),
+          fixed(generic ? nullptr : pickFixed(_k, make_index_sequence<32>())),
+          words((2 * _k + 63) / 64) {
+        st.reserve(k);
+    }
+
+    // encode `blocks` consecutive blocks of a
+    void encode(const long long *a, int blocks, string &out) {
+        if (fixed) {
+            sigs.resize(blocks);
+            fixed(a, blocks, sigs.data());
+            for (int b = 0; b < blocks; b++) emit(&sigs[b], out);
+            return;
+        }
+        for (int b = 0; b < blocks; b++) {
+            encodeGeneric(a + (size_t)b * k);
+            emit(words.data(), out);
+        }
+    }
+};
+
+// Reader → workers → writer pipeline.  The reader parses batches of blocks
+// into a ring of slots, workers encode whole batches with their own
+// Encoder, and the writer (the calling thread) flushes slots in input order,
+// so the output is byte-identical to the sequential loop.
+static void runPipeline(FastInput &in, FastOutput &out, int k, long long m, Format format,
+                        bool binary, bool generic, int threads) {
+    enum State { FREE, FILLED, BUSY, DONE };
+    struct Slot {
+        State state = FREE;
+        long long id = -1;
+        int blocks = 0;
+        vector<long long> vals;
+        string out;
+    };
+
+    const int perBatch = max(1, (1 << 16) / max(k, 1));
+    const long long batches = (m + perBatch - 1) / perBatch;
+    vector<Slot> ring(2 * threads + 2);
+    mutex mu;
+    condition_variable cv;
+    deque<int> work;
+    bool eof = false;
+
+    thread reader([&] {
+        for (long long id = 0; id < batches; id++) {
+            Slot &s = ring[id % ring.size()];
+            {
+                unique_lock<mutex> lk(mu);
+                cv.wait(lk, [&] { return s.state == FREE; });
+            }
+            s.id = id;
+            s.blocks = (int)min<long long>(perBatch, m - id * perBatch);
+            s.vals.resize((size_t)s.blocks * k);
+            for (auto &v : s.vals) {
+                if (!in.next(v)) v = 0;
+            }
+            {
+                lock_guard<mutex> lk(mu);
+                s.state = FILLED;
+                work.push_back(id % ring.size());
+            }
+            cv.notify_all();
+        }
+        lock_guard<mutex> lk(mu);
+        eof = true;
+        cv.notify_all();
+    });
+
+    vector<thread> workers;
+    for (int w = 0; w < threads; w++) {
+        workers.emplace_back([&] {
+            Encoder enc(k, format, binary, generic);
+            while (true) {
+                int idx;
+                {
+                    unique_lock<mutex> lk(mu);
+                    cv.wait(lk, [&] { return !work.empty() || eof; });
+                    if (work.empty()) return;
+                    idx = work.front();
+                    work.pop_front();
+                    ring[idx].state = BUSY;
+                }
+                Slot &s = ring[idx];
+                s.out.clear();
+                enc.encode(s.vals.data(), s.blocks, s.out);
+                {
+                    lock_guard<mutex> lk(mu);
+                    s.state = DONE;
+                }
+                cv.notify_all();
+            }
+        });
+    }
+
+    for (long long id = 0; id < batches; id++) {
+        Slot &s = ring[id % ring.size()];
+        {
+            unique_lock<mutex> lk(mu);
+            cv.wait(lk, [&] { return s.state == DONE && s.id == id; });
+        }
+        out << s.out;
+        {
+            lock_guard<mutex> lk(mu);
+            s.state = FREE;
+        }
+        cv.notify_all();
+    }
 
-        // 'encoding' now has length 2*k
-        cout << encoding << "\n";
+    reader.join();
+    for (auto &w : workers) w.join();
+}
+
+// Cartesian tree of a single array: the tree the stack loop above builds,
+// so equal values put the later element in the right subtree.
+struct CartesianTree {
+    int root = -1;
+    vector<int> parent, left, right;    // -1 = none
+    vector<uint64_t> bp;                // 2n-bit signature, LSB-first as Format::Bits
+};
+
+// run f(c) for c = 0…chunks-1, one thread per chunk
+template <class F>
+static void parallelFor(int chunks, F f) {
+    vector<thread> pool;
+    for (int c = 1; c < chunks; c++) pool.emplace_back(f, c);
+    f(0);
+    for (auto &th : pool) th.join();
+}
+
+// Parallel all-nearest-smaller-values construction.  With
+//   R[i] = nearest j > i with a[j] <  a[i]   (the element that pops i)
+//   L[i] = nearest j < i with a[j] <= a[i]   (the element below i on the stack)
+// the parent of i is the larger of a[L[i]], a[R[i]] (R on ties), and the
+// stack holds s_i = 1 + s_{L[i]} elements after pushing i, so the '0' of i
+// sits at bit 2i + 1 - s_i and every other bit is a '1'.
+// Each chunk solves R and L with a local stack; the unresolved elements
+// (its final stack) are matched against the prefix/suffix minimum records
+// of the other chunks.
+static CartesianTree buildCartesianTree(const vector<long long> &a, int threads) {
+    const int n = a.size();
+    CartesianTree t;
+    t.parent.assign(n, -1);
+    t.left.assign(n, -1);
+    t.right.assign(n, -1);
+    const size_t bits = (size_t)2 * n;
+    t.bp.assign((bits + 63) / 64, ~0ULL);
+    if (n == 0) return t;
+    if (bits % 64) t.bp.back() = (1ULL << (bits % 64)) - 1;
+
+    const int C = max(1, min(threads, n));
+    auto lo = [&](int c) { return (int)((long long)n * c / C); };
+    vector<int> R(n, -1), L(n, -1);
+    vector<vector<int>> openR(C), openL(C);     // unresolved, stack order
+    vector<vector<int>> preMin(C), sufMin(C);   // strict min records
+    vector<long long> chunkMin(C);
+
+    // 1) chunk-local stacks
+    parallelFor(C, [&](int c) {
+        int b = lo(c), e = lo(c + 1);
+        vector<int> &st = openR[c];
+        for (int i = b; i < e; i++) {
+            while (!st.empty() && a[st.back()] > a[i]) { R[st.back()] = i; st.pop_back(); }
+            st.push_back(i);
+            if (preMin[c].empty() || a[i] < a[preMin[c].back()]) preMin[c].push_back(i);
+        }
+        vector<int> &sl = openL[c];
+        for (int i = e - 1; i >= b; i--) {
+            while (!sl.empty() && a[sl.back()] >= a[i]) { L[sl.back()] = i; sl.pop_back(); }
+            sl.push_back(i);
+            if (sufMin[c].empty() || a[i] < a[sufMin[c].back()]) sufMin[c].push_back(i);
+        }
+        chunkMin[c] = a[preMin[c].back()];
+    });
+
+    // 2) resolve across chunks; from the top of each open stack down the
+    //    values shrink, so the candidate chunk only moves away
+    parallelFor(C, [&](int c) {
+        int d = c + 1;
+        for (int k = (int)openR[c].size() - 1; k >= 0; k--) {
+            int j = openR[c][k];
+            while (d < C && chunkMin[d] >= a[j]) d++;
+            if (d == C) break;
+            auto &rec = preMin[d];      // decreasing values
+            R[j] = *partition_point(rec.begin(), rec.end(),
+                                    [&](int x) { return a[x] >= a[j]; });
+        }
+        d = c - 1;
+        for (int k = (int)openL[c].size() - 1; k >= 0; k--) {
+            int j = openL[c][k];
+            while (d >= 0 && chunkMin[d] > a[j]) d--;
+            if (d < 0) break;
+            auto &rec = sufMin[d];      // decreasing values, right to left
+            L[j] = *partition_point(rec.begin(), rec.end(),
+                                    [&](int x) { return a[x] > a[j]; });
+        }
+    });
+
+    // 3) stack depths: s_i = 1 + s_{L[i]}.  Chunk-local depths first; the
+    //    chain of i leaves its chunk at exitOf[i], an element of an earlier
+    //    chunk.  Only those exit elements need their full depth, and an
+    //    exit element's own exit is a smaller one, so one ascending pass
+    //    over them finishes them (exitOf = -1 marks a finished depth).
+    vector<int> depth(n), exitOf(n);
+    parallelFor(C, [&](int c) {
+        int b = lo(c), e = lo(c + 1);
+        for (int i = b; i < e; i++) {
+            int l = L[i];
+            if (l >= b) { depth[i] = depth[l] + 1; exitOf[i] = exitOf[l]; }
+            else        { depth[i] = 1;            exitOf[i] = l; }
+        }
+    });
+    vector<int> exits;
+    for (int c = 0; c < C; c++)
+        for (int x : openL[c])
+            if (L[x] >= 0) exits.push_back(L[x]);
+    sort(exits.begin(), exits.end());
+    exits.erase(unique(exits.begin(), exits.end()), exits.end());
+    for (int y : exits) {
+        if (exitOf[y] >= 0) depth[y] += depth[exitOf[y]];
+        exitOf[y] = -1;
+    }
+    parallelFor(C, [&](int c) {
+        for (int i = lo(c), e = lo(c + 1); i < e; i++)
+            if (exitOf[i] >= 0) depth[i] += depth[exitOf[i]];
+    });
+
+    // 4) parents, children and the signature bits
+    vector<vector<int>> edgeBits(C);
+    parallelFor(C, [&](int c) {
+        int b = lo(c), e = lo(c + 1);
+        size_t firstW = ((size_t)2 * b + 1 - depth[b]) >> 6;
+        size_t lastW = ((size_t)2 * (e - 1) + 1 - depth[e - 1]) >> 6;
+        for (int i = b; i < e; i++) {
+            int l = L[i], r = R[i];
+            if (l < 0 && r < 0) t.root = i;
+            else if (l < 0) t.parent[i] = r;
+            else if (r < 0) t.parent[i] = l;
+            else t.parent[i] = a[r] >= a[l] ? r : l;
+            size_t p = (size_t)2 * i + 1 - depth[i], w = p >> 6;
+            // words shared with a neighboring chunk are cleared afterwards
+            if (w == firstW || w == lastW) edgeBits[c].push_back(i);
+            else t.bp[w] &= ~(1ULL << (p & 63));
+        }
+    });
+    for (int c = 0; c < C; c++) {
+        for (int i : edgeBits[c]) {
+            size_t p = (size_t)2 * i + 1 - depth[i];
+            t.bp[p >> 6] &= ~(1ULL << (p & 63));
+        }
+    }
+    parallelFor(C, [&](int c) {
+        for (int i = lo(c), e = lo(c + 1); i < e; i++) {
+            int p = t.parent[i];
+            if (p < 0) continue;
+            if (p > i) t.left[p] = i;
+            else t.right[p] = i;
+        }
+    });
+    return t;
+}
+
+// --tree input: n, then n values.  Output: the 2n-bit signature (text, or
+// bits words with --format=bits / --binary), then the parent array.
+static int solveTree(FastInput &in, FastOutput &os, Format format, bool binary, int threads) {
+    if (format == Format::Catalan) {
+        cerr << "--tree supports text and bits formats\n";
+        return 1;
+    }
+    long long nn = 0;
+    in.next(nn);
+    vector<long long> a(nn);
+    for (auto &v : a) in.next(v);
+    CartesianTree t = buildCartesianTree(a, max(threads, 1));
+
+    // streamed through os: at n = 10^9 the text output alone is ~10 GB
+    if (binary) {
+        os.write(reinterpret_cast<const char*>(t.bp.data()), t.bp.size() * sizeof(uint64_t));
+        os.write(reinterpret_cast<const char*>(t.parent.data()), t.parent.size() * sizeof(int));
+        return 0;
+    }
+    if (format == Format::Text) {
+        char chunk[64];
+        for (size_t j = 0, bits = 2 * a.size(); j < bits; j += 64) {
+            int len = (int)min<size_t>(64, bits - j);
+            for (int b = 0; b < len; b++) chunk[b] = '0' + ((t.bp[j >> 6] >> b) & 1);
+            os.write(chunk, len);
+        }
+    } else {
+        for (size_t w = 0; w < t.bp.size(); w++) {
+            if (w) os << ' ';
+            os << t.bp[w];
+        }
+    }
+    os << '\n';
+    for (size_t i = 0; i < a.size(); i++) {
+        if (i) os << ' ';
+        os << t.parent[i];
+    }
+    os << '\n';
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    FastInput in;
+    FastOutput os;
+
+    // --format=text (default) | bits | catalan, --binary writes the packed
+    // words raw (little-endian uint64) instead of as decimal text,
+    // --threads=T encodes with the reader/worker/writer pipeline,
+    // --generic uses the stack loop even for k ≤ 32 (for comparison),
+    // --tree builds the Cartesian tree of one array (threads = chunks)
+    Format format = Format::Text;
+    bool binary = false, generic = false, tree = false;
+    int threads = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--format=bits") format = Format::Bits;
+        else if (arg == "--format=catalan") format = Format::Catalan;
+        else if (arg == "--binary") binary = true;
+        else if (arg == "--generic") generic = true;
+        else if (arg == "--tree") tree = true;
+        else if (arg.rfind("--threads=", 0) == 0) threads = stoi(arg.substr(10));
+    }
+    if (binary && format == Format::Text) format = Format::Bits;
+
+    if (tree) return solveTree(in, os, format, binary, threads);
+    int k = 0, m = 0;
+    in.next(k, m);
+    if (format == Format::Catalan) {
+        if (k > 35) {
+            cerr << "catalan format needs k <= 35\n";
+            return 1;
+        }
+        buildCompletions(k);
+    }
+
+    if (threads > 0) {
+        runPipeline(in, os, k, m, format, binary, generic, threads);
+        return 0;
+    }
+
+    // read and encode up to 1024 blocks at a time
+    Encoder enc(k, format, binary, generic);
+    const int batch = 1024;
+    vector<long long> a((size_t)k * batch);
+    string out;
+    while (m > 0) {
+        int blocks = min(m, batch);
+        for (size_t i = 0; i < (size_t)k * blocks; i++) {
+            if (!in.next(a[i])) a[i] = 0;
+        }
+        out.clear();
+        enc.encode(a.data(), blocks, out);
+        os << out;
+        m -= blocks;
     }
 
     return 0;
@@ -3,109 +3,264 @@
 #include <bits/stdc++.h>
 using namespace std;
 
+// ---- shared d2-type-tables: edit here, then run sync_d2.py ----
 // block size recommendation from hint
 static const int B = 9;
 
-// global storage for the array and RMQ structures
-static int *G = nullptr;            // pointer to input array
-static int  N = 0;                  // array length
-static int  nb = 0;                 // number of blocks
-static int *block_min_idx = nullptr; // block_min_idx[i] = index of minimum in block i
-static int **st = nullptr;          // sparse table over blocks (stores block indices)
-static int *log_2 = nullptr;        // precomputed floor(log2)
+// Fischer-Heun in-block tables.  A block's Cartesian-tree type is the rank
+// of its push/pop signature (the D1.cpp stack encoding) among the C_B
+// possible shapes; blocks of the same type have their minimum at the same
+// offset for every in-block range, so one table per type answers them all.
+// The tables depend on the shape alone, so they are built once and shared
+// by every RMQ instance.
+static const int NT = 4862;         // C_9 = number of types for B = 9
 
-// Preprocess in O(n)
-void warm_up(int seq[], int n) {
-    G = seq;
-    N = n;
-    if (N <= 0) return;
-
-    // number of blocks of size B
-    nb = (N + B - 1) / B;
-
-    // allocate
-    block_min_idx = (int*)malloc(nb * sizeof(int));
-    log_2         = (int*)malloc((nb + 1) * sizeof(int));
-
-    // 1) per-block minimum
-    for (int bi = 0; bi < nb; bi++) {
-        int start = bi * B;
-        int end   = min(N, start + B);
-        int mi = start;
-        for (int j = start + 1; j < end; j++) {
-            if (seq[j] < seq[mi]) mi = j;
-        }
-        block_min_idx[bi] = mi;
-    }
+struct TypeTables {
+    unsigned ballot[B + 1][B + 1];      // completions from (pushes, pops)
+    unsigned char in_block[NT][B][B];   // in_block[type][l][r] = offset of the min
 
-    // 2) build log2 table up to nb
-    log_2[1] = 0;
-    for (int i = 2; i <= nb; i++) {
-        log_2[i] = log_2[i >> 1] + 1;
+    TypeTables() {
+        // ballot numbers: ways to finish a signature from (pushes, pops)
+        for (int o = B; o >= 0; o--) {
+            for (int c = o; c >= 0; c--) {
+                if (o == B && c == B) { ballot[o][c] = 1; continue; }
+                ballot[o][c] = (o < B ? ballot[o + 1][c] : 0)
+                             + (c < o ? ballot[o][c + 1] : 0);
+            }
+        }
+        for (int t = 0; t < NT; t++) {
+            buildTable(t);
+        }
     }
 
-    // 3) build sparse table on blocks
-    int K = log_2[nb] + 1;
-    st = (int**)malloc(K * sizeof(int*));
-    // level 0
-    st[0] = (int*)malloc(nb * sizeof(int));
-    for (int i = 0; i < nb; i++) {
-        st[0][i] = i;
-    }
-    // higher levels
-    for (int k = 1; k < K; k++) {
-        int span = 1 << k;
-        int half = 1 << (k - 1);
-        st[k] = (int*)malloc((nb - span + 1) * sizeof(int));
-        for (int i = 0; i + span <= nb; i++) {
-            int x = st[k - 1][i];
-            int y = st[k - 1][i + half];
-            int vx = seq[ block_min_idx[x] ];
-            int vy = seq[ block_min_idx[y] ];
-            st[k][i] = (vx <= vy ? x : y);
+    // unrank signature t and replay the stack to recover the tree; the
+    // minimum of [l, r] is the shallowest node in that range
+    void buildTable(int t) {
+        int parent[B], st[B], top = 0, last = -1, i = 0, rank = t;
+        for (int o = 0, c = 0; o + c < 2 * B; ) {
+            if (o < B && rank < (int)ballot[o + 1][c]) {
+                // '0' (push): the last popped node becomes i's left child,
+                // and i becomes the right child of the new top
+                if (last >= 0) parent[last] = i;
+                parent[i] = top > 0 ? st[top - 1] : -1;
+                st[top++] = i++;
+                last = -1;
+                o++;
+            } else {
+                // '1' (pop)
+                if (o < B) rank -= ballot[o + 1][c];
+                last = st[--top];
+                c++;
+            }
+        }
+        int depth[B];
+        for (int v = 0; v < B; v++) {
+            depth[v] = 0;
+            for (int u = parent[v]; u >= 0; u = parent[u]) depth[v]++;
+        }
+        for (int l = 0; l < B; l++) {
+            int mi = l;
+            for (int r = l; r < B; r++) {
+                if (depth[r] < depth[mi]) mi = r;
+                in_block[t][l][r] = (unsigned char)mi;
+            }
         }
     }
+};
+
+static const TypeTables &typeTables() {
+    static const TypeTables tables;
+    return tables;
 }
+// ---- end shared d2-type-tables ----
 
-// Query in O(1)
-int query(int L, int R) {
-    if (L < 0 || R < L || R >= N) return -1;
+// Block-decomposed RMQ over an array it does not own.  All per-array state
+// (block minima, log table, every sparse-table level back to back, block
+// types) lives in one 64-byte-aligned arena owned by the instance, so any
+// number of arrays can be indexed at once and nothing leaks on rebuild.
+class RMQ {
+    static const int MAXK = 32;
 
-    int bi = L / B;
-    int bj = R / B;
-    int ans = INT_MAX;
+    const int *G = nullptr;             // pointer to input array
+    int N = 0;                          // array length
+    int nb = 0;                         // number of blocks
+    int K = 0;                          // number of sparse-table levels
+    void *arena = nullptr;              // single allocation for everything below
+    size_t arena_bytes = 0;
+    int *block_min_idx = nullptr;       // block_min_idx[i] = index of minimum in block i
+    int *log_2 = nullptr;               // precomputed floor(log2)
+    int *st[MAXK] = {};                 // sparse table over blocks (stores block indices)
+    unsigned short *block_type = nullptr; // Cartesian-tree type of each block
 
-    // same block: brute force
-    if (bi == bj) {
-        for (int i = L; i <= R; i++) {
-            ans = min(ans, G[i]);
-        }
-        return ans;
+    void release() {
+        if (arena) ::operator delete(arena, align_val_t(64));
+        arena = nullptr;
+        arena_bytes = 0;
     }
 
-    // left partial block
-    int endL = (bi + 1) * B;
-    for (int i = L; i < endL; i++) {
-        ans = min(ans, G[i]);
+    static size_t alignUp(size_t x) { return (x + 63) & ~size_t(63); }
+
+    // index of the minimum of [l, r] inside block bi
+    int inMin(int bi, int l, int r) const {
+        return bi * B + typeTables().in_block[ block_type[bi] ][l][r];
+    }
+
+public:
+    RMQ() = default;
+    RMQ(const int *seq, int n) { build(seq, n); }
+    ~RMQ() { release(); }
+
+    RMQ(const RMQ &) = delete;
+    RMQ &operator=(const RMQ &) = delete;
+    RMQ(RMQ &&o) noexcept { swap(o); }
+    RMQ &operator=(RMQ &&o) noexcept {
+        RMQ tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+
+    void swap(RMQ &o) noexcept {
+        std::swap(G, o.G);
+        std::swap(N, o.N);
+        std::swap(nb, o.nb);
+        std::swap(K, o.K);
+        std::swap(arena, o.arena);
+        std::swap(arena_bytes, o.arena_bytes);
+        std::swap(block_min_idx, o.block_min_idx);
+        std::swap(log_2, o.log_2);
+        std::swap(st, o.st);
+        std::swap(block_type, o.block_type);
     }
 
-    // right partial block
-    int startR = bj * B;
-    for (int i = startR; i <= R; i++) {
-        ans = min(ans, G[i]);
+    // Preprocess in O(n); seq must outlive the structure
+    void build(const int *seq, int n) {
+        G = seq;
+        N = max(n, 0);
+        if (N <= 0) return;
+
+        // number of blocks of size B
+        nb = (N + B - 1) / B;
+        int lg = 0;
+        while ((2 << lg) <= nb) lg++;
+        K = lg + 1;
+
+        // lay out the arena: each array starts on a cache line
+        size_t offMin = 0;
+        size_t offLog = alignUp(offMin + nb * sizeof(int));
+        size_t offSt[MAXK];
+        size_t off = alignUp(offLog + (nb + 1) * sizeof(int));
+        for (int k = 0; k < K; k++) {
+            offSt[k] = off;
+            off = alignUp(off + (nb - (1 << k) + 1) * sizeof(int));
+        }
+        size_t offType = off;
+        size_t bytes = offType + nb * sizeof(unsigned short);
+
+        // allocate (or reuse a large enough arena from a previous build)
+        if (bytes > arena_bytes) {
+            release();
+            arena = ::operator new(bytes, align_val_t(64));
+            arena_bytes = bytes;
+        }
+        char *base = static_cast<char*>(arena);
+        block_min_idx = reinterpret_cast<int*>(base + offMin);
+        log_2         = reinterpret_cast<int*>(base + offLog);
+        for (int k = 0; k < K; k++) {
+            st[k] = reinterpret_cast<int*>(base + offSt[k]);
+        }
+        block_type    = reinterpret_cast<unsigned short*>(base + offType);
+
+        // 1) per-block type and minimum; the short last block is padded
+        //    with INT_MAX, which never pops anything
+        const TypeTables &tt = typeTables();
+        for (int bi = 0; bi < nb; bi++) {
+            int start = bi * B;
+            int vals[B], stk[B], top = 0;
+            int type = 0, pushes = 0, pops = 0;
+            for (int i = 0; i < B; i++) {
+                vals[i] = (start + i < N) ? seq[start + i] : INT_MAX;
+                // '1' (pop): every signature that pushes here instead ranks first
+                while (top > 0 && vals[stk[top - 1]] > vals[i]) {
+                    top--;
+                    type += tt.ballot[pushes + 1][pops];
+                    pops++;
+                }
+                stk[top++] = i;   // '0' (push)
+                pushes++;
+            }
+            block_type[bi] = (unsigned short)type;
+            block_min_idx[bi] = start + tt.in_block[type][0][B - 1];
+        }
+
+        // 2) build log2 table up to nb
+        log_2[1] = 0;
+        for (int i = 2; i <= nb; i++) {
+            log_2[i] = log_2[i >> 1] + 1;
+        }
+
+        // 3) build sparse table on blocks
+        // level 0
+        for (int i = 0; i < nb; i++) {
+            st[0][i] = i;
+        }
+        // higher levels
+        for (int k = 1; k < K; k++) {
+            int span = 1 << k;
+            int half = 1 << (k - 1);
+            for (int i = 0; i + span <= nb; i++) {
+                int x = st[k - 1][i];
+                int y = st[k - 1][i + half];
+                int vx = seq[ block_min_idx[x] ];
+                int vy = seq[ block_min_idx[y] ];
+                st[k][i] = (vx <= vy ? x : y);
+            }
+        }
     }
 
-    // full blocks in between
-    if (bj - bi > 1) {
-        int l = bi + 1, r = bj - 1;
-        int len = r - l + 1;
-        int k = log_2[len];
-        int x = st[k][l];
-        int y = st[k][r - (1 << k) + 1];
-        int vx = G[ block_min_idx[x] ];
-        int vy = G[ block_min_idx[y] ];
-        ans = min(ans, min(vx, vy));
+    int size() const { return N; }
+
+    // Query in O(1)
+    int query(int L, int R) const {
+        if (L < 0 || R < L || R >= N) return -1;
+
+        int bi = L / B;
+        int bj = R / B;
+        int si = bi * B, sj = bj * B;
+
+        // same block: one table lookup
+        if (bi == bj) {
+            return G[ inMin(bi, L - si, R - si) ];
+        }
+
+        // left partial block
+        int ans = G[ inMin(bi, L - si, B - 1) ];
+
+        // right partial block
+        ans = min(ans, G[ inMin(bj, 0, R - sj) ]);
+
+        // full blocks in between
+        if (bj - bi > 1) {
+            int l = bi + 1, r = bj - 1;
+            int len = r - l + 1;
+            int k = log_2[len];
+            int x = st[k][l];
+            int y = st[k][r - (1 << k) + 1];
+            int vx = G[ block_min_idx[x] ];
+            int vy = G[ block_min_idx[y] ];
+            ans = min(ans, min(vx, vy));
+        }
+
+        return ans;
     }
+};
 
-    return ans;
+// judge interface: one process-wide instance, rebuilt by every warm_up
+static RMQ rmq;
+
+void warm_up(int seq[], int n) {
+    rmq.build(seq, n);
+}
+
+int query(int L, int R) {
+    return rmq.query(L, R);
 }
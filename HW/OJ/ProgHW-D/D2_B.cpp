@@ -1,67 +1,665 @@
 /* ProbId: D2-AB-Optimal-RMQ */
 
 #include <algorithm>
+#include <chrono>
 #include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// In-block RMQ, chosen at compile time:
+// - default: Fischer-Heun type tables with B = 9
+// - -DRMQ_STACK_MASKS: table-free word-RAM masks with B = 64
+#ifdef RMQ_STACK_MASKS
+static const int B = 64;
+#else
+// ---- shared d2-type-tables: edit in D2_A.cpp, then run sync_d2.py ----
+// block size recommendation from hint
 static const int B = 9;
-static int *G;
-static int  N, nb;
-static int *block_min_idx;
-static int **st;
-static int *log_2;
 
-void warm_up(int seq[], int n) {
-    G = seq;
-    N = n;
-    if (N <= 0) return;
-    nb = (N + B - 1) / B;
-    block_min_idx = (int*)std::malloc(nb * sizeof(int));
-    log_2         = (int*)std::malloc((nb + 1) * sizeof(int));
-    for (int bi = 0; bi < nb; ++bi) {
-        int s = bi * B, e = std::min(N, s + B), mi = s;
-        for (int i = s + 1; i < e; ++i)
-            if (seq[i] < seq[mi]) mi = i;
-        block_min_idx[bi] = mi;
-    }
-    log_2[1] = 0;
-    for (int i = 2; i <= nb; ++i)
-        log_2[i] = log_2[i >> 1] + 1;
-    int K = log_2[nb] + 1;
-    st = (int**)std::malloc(K * sizeof(int*));
-    st[0] = (int*)std::malloc(nb * sizeof(int));
-    for (int i = 0; i < nb; ++i)
-        st[0][i] = i;
-    for (int k = 1; k < K; ++k) {
-        int span = 1 << k, half = span >> 1;
-        st[k] = (int*)std::malloc((nb - span + 1) * sizeof(int));
-        for (int i = 0; i + span <= nb; ++i) {
-            int x = st[k - 1][i], y = st[k - 1][i + half];
-            int vx = seq[block_min_idx[x]], vy = seq[block_min_idx[y]];
-            st[k][i] = (vx <= vy ? x : y);
+// Fischer-Heun in-block tables.  A block's Cartesian-tree type is the rank
+// of its push/pop signature (the D1.cpp stack encoding) among the C_B
+// possible shapes; blocks of the same type have their minimum at the same
+// offset for every in-block range, so one table per type answers them all.
+// The tables depend on the shape alone, so they are built once and shared
+// by every RMQ instance.
+static const int NT = 4862;         // C_9 = number of types for B = 9
+
+struct TypeTables {
+    unsigned ballot[B + 1][B + 1];      // completions from (pushes, pops)
+    unsigned char in_block[NT][B][B];   // in_block[type][l][r] = offset of the min
+
+    TypeTables() {
+        // ballot numbers: ways to finish a signature from (pushes, pops)
+        for (int o = B; o >= 0; o--) {
+            for (int c = o; c >= 0; c--) {
+                if (o == B && c == B) { ballot[o][c] = 1; continue; }
+                ballot[o][c] = (o < B ? ballot[o + 1][c] : 0)
+                             + (c < o ? ballot[o][c + 1] : 0);
+            }
+        }
+        for (int t = 0; t < NT; t++) {
+            buildTable(t);
         }
     }
+
+    // unrank signature t and replay the stack to recover the tree; the
+    // minimum of [l, r] is the shallowest node in that range
+    void buildTable(int t) {
+        int parent[B], st[B], top = 0, last = -1, i = 0, rank = t;
+        for (int o = 0, c = 0; o + c < 2 * B; ) {
+            if (o < B && rank < (int)ballot[o + 1][c]) {
+                // '0' (push): the last popped node becomes i's left child,
+                // and i becomes the right child of the new top
+                if (last >= 0) parent[last] = i;
+                parent[i] = top > 0 ? st[top - 1] : -1;
+                st[top++] = i++;
+                last = -1;
+                o++;
+            } else {
+                // '1' (pop)
+                if (o < B) rank -= ballot[o + 1][c];
+                last = st[--top];
+                c++;
+            }
+        }
+        int depth[B];
+        for (int v = 0; v < B; v++) {
+            depth[v] = 0;
+            for (int u = parent[v]; u >= 0; u = parent[u]) depth[v]++;
+        }
+        for (int l = 0; l < B; l++) {
+            int mi = l;
+            for (int r = l; r < B; r++) {
+                if (depth[r] < depth[mi]) mi = r;
+                in_block[t][l][r] = (unsigned char)mi;
+            }
+        }
+    }
+};
+
+static const TypeTables &typeTables() {
+    static const TypeTables tables;
+    return tables;
 }
+// ---- end shared d2-type-tables ----
+#endif
 
-int query(int L, int R) {
-    if (L < 0 || R < L || R >= N) return -1;
-    int bi = L / B, bj = R / B, ans = INT_MAX;
-    if (bi == bj) {
-        for (int i = L; i <= R; ++i)
-            ans = std::min(ans, G[i]);
+// Read-only mapping of a whole file, unmapped by the destructor.  Used for
+// saved RMQ indexes and for input arrays stored as raw host-order ints
+// (save_array), so a restarted process pages both in instead of rebuilding.
+class MappedFile {
+    void *base = nullptr;
+    size_t bytes = 0;
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const char *path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&o) noexcept { swap(o); }
+    MappedFile &operator=(MappedFile &&o) noexcept {
+        MappedFile tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+
+    void swap(MappedFile &o) noexcept {
+        std::swap(base, o.base);
+        std::swap(bytes, o.bytes);
+    }
+
+    bool open(const char *path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat sb;
+        void *p = MAP_FAILED;
+        if (fstat(fd, &sb) == 0 && sb.st_size > 0)
+            p = mmap(nullptr, (size_t)sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base = p;
+        bytes = (size_t)sb.st_size;
+        return true;
+    }
+
+    void close() {
+        if (base) munmap(base, bytes);
+        base = nullptr;
+        bytes = 0;
+    }
+
+    const char *data() const { return static_cast<const char*>(base); }
+    size_t size() const { return bytes; }
+
+    // the file as an int array
+    const int *ints() const { return reinterpret_cast<const int*>(base); }
+    int count() const { return (int)(bytes / sizeof(int)); }
+};
+
+// raw array file for MappedFile::ints()
+inline bool save_array(const char *path, const int *seq, int n) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(seq, sizeof(int), n, f) == (size_t)n;
+    return fclose(f) == 0 && ok;
+}
+
+// 64-bit checksum: four independent xor-multiply-rotate lanes over 8-byte
+// words so a multi-GB index is hashed at memory speed, then the tail
+static uint64_t checksum64(const void *p, size_t bytes) {
+    const uint64_t P = 0x9E3779B97F4A7C15ULL;
+    const unsigned char *c = static_cast<const unsigned char*>(p);
+    uint64_t h[4] = {1, 2, 3, 4}, w;
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32)
+        for (int j = 0; j < 4; ++j) {
+            memcpy(&w, c + i + 8 * j, 8);
+            h[j] = (h[j] ^ w) * P;
+            h[j] = h[j] << 31 | h[j] >> 33;
+        }
+    uint64_t r = bytes;
+    for (int j = 0; j < 4; ++j) r = (r ^ h[j]) * P;
+    for (; i < bytes; ++i) r = (r ^ c[i]) * P;
+    return r ^ r >> 29;
+}
+
+// Block-decomposed RMQ over an int array it does not own.  Every piece of
+// state (block minima, log table, all sparse-table levels back to back and
+// the in-block data) lives in one 64-byte-aligned arena that is released
+// by the destructor or reused by the next build().  save() writes the
+// arena verbatim behind a header page; load() maps such a file and points
+// the arrays into the mapping, so a saved index is queried in place.
+class RMQ {
+    static const int MAXK = 32;
+    static const size_t HEADER_BYTES = 4096;    // keeps the arena page aligned
+    static const uint32_t INDEX_VERSION = 1;
+
+    // on-disk header; integers in host byte order
+    struct IndexHeader {
+        char magic[8];                  // "D2RMQIDX"
+        uint32_t version, block;        // INDEX_VERSION, B (tables or masks)
+        int64_t n, nb, k;
+        uint64_t bytes;                 // arena size that follows the header
+        uint64_t checksum;              // checksum64 of the arena
+        uint64_t data_checksum;         // checksum64 of seq[0..n)
+    };
+
+    const int *G = nullptr;
+    int N = 0, nb = 0, K = 0;
+    void *arena = nullptr;
+    size_t arena_bytes = 0;
+    size_t used_bytes = 0;              // layout size of the current index
+    MappedFile mapped;                  // backs the arrays after load()
+    double build_sec = 0;
+    int *block_min_idx = nullptr;
+    int *log_2 = nullptr;
+    int *st[MAXK] = {};                 // level k: nb - 2^k + 1 block indices
+#ifdef RMQ_STACK_MASKS
+    uint64_t *pos_mask = nullptr;
+#else
+    unsigned short *block_type = nullptr;
+#endif
+
+    void release() {
+        if (arena) ::operator delete(arena, std::align_val_t(64));
+        arena = nullptr;
+        arena_bytes = 0;
+        mapped.close();
+    }
+
+    static size_t align_up(size_t x) { return (x + 63) & ~size_t(63); }
+
+    // arena layout for the current N, nb, K: each array starts on a cache
+    // line.  Returns the size; with a base, also points the arrays into it.
+    size_t layout(char *base) {
+        size_t off_min = 0;
+        size_t off_log = align_up(off_min + nb * sizeof(int));
+        size_t off_st[MAXK];
+        size_t off = align_up(off_log + (nb + 1) * sizeof(int));
+        for (int k = 0; k < K; ++k) {
+            off_st[k] = off;
+            off = align_up(off + (nb - (1 << k) + 1) * sizeof(int));
+        }
+        size_t off_in = off;
+#ifdef RMQ_STACK_MASKS
+        size_t bytes = off_in + N * sizeof(uint64_t);
+#else
+        size_t bytes = off_in + nb * sizeof(unsigned short);
+#endif
+        if (!base) return bytes;
+        block_min_idx = reinterpret_cast<int*>(base + off_min);
+        log_2 = reinterpret_cast<int*>(base + off_log);
+        for (int k = 0; k < K; ++k) st[k] = reinterpret_cast<int*>(base + off_st[k]);
+#ifdef RMQ_STACK_MASKS
+        pos_mask = reinterpret_cast<uint64_t*>(base + off_in);
+#else
+        block_type = reinterpret_cast<unsigned short*>(base + off_in);
+#endif
+        return bytes;
+    }
+
+    // block count and sparse-table depth for N
+    void set_shape() {
+        nb = (N + B - 1) / B;
+        int lg = 0;
+        while ((2 << lg) <= nb) ++lg;
+        K = lg + 1;
+    }
+
+    const char *arena_data() const {
+        return arena ? static_cast<const char*>(arena) : mapped.data() + HEADER_BYTES;
+    }
+
+    // one sparse-table level from the previous one: the winner of cells i
+    // and i + half, with its value carried along for the next level.  Four
+    // cells per step with GCC vector types (a compare gives an all-ones
+    // mask per lane), since -O2 does not vectorise the select on its own.
+    static void fill_level(const int *__restrict px, const int *__restrict pv,
+                           int *__restrict ox, int *__restrict ov, int half, int cnt) {
+        typedef int v4 __attribute__((vector_size(16)));
+        int i = 0;
+        for (; i + 4 <= cnt; i += 4) {
+            v4 a, b, x, y;
+            __builtin_memcpy(&a, pv + i, 16), __builtin_memcpy(&b, pv + i + half, 16);
+            __builtin_memcpy(&x, px + i, 16), __builtin_memcpy(&y, px + i + half, 16);
+            v4 m = a <= b;
+            x = (x & m) | (y & ~m), a = (a & m) | (b & ~m);
+            __builtin_memcpy(ox + i, &x, 16), __builtin_memcpy(ov + i, &a, 16);
+        }
+        for (; i < cnt; ++i) {
+            int a = pv[i], b = pv[i + half];
+            ox[i] = a <= b ? px[i] : px[i + half];
+            ov[i] = std::min(a, b);
+        }
+    }
+
+    // f(lo, hi) over [0, n) in `threads` contiguous slices (already capped
+    // by cap_threads); small ranges are not worth a thread
+    template <class F>
+    static void parallel_for(int n, int threads, F f) {
+        if (threads <= 1 || n < (1 << 16)) { f(0, n); return; }
+        std::vector<std::thread> pool;
+        int per = (n + threads - 1) / threads;
+        for (int s = 0; s < n; s += per)
+            pool.emplace_back(f, s, std::min(n, s + per));
+        for (auto &t : pool) t.join();
+    }
+
+#ifdef RMQ_STACK_MASKS
+    // pos_mask[i] = monotonic stack of i's block right after pushing i, one
+    // bit per in-block position.  The lowest stack entry at or after l is
+    // the leftmost minimum of [l, r], so a query is a mask, a shift and a ctz.
+    void build_in_block(int b0, int b1) {
+        for (int bi = b0; bi < b1; ++bi) {
+            int s = bi * B, e = std::min(N, s + B);
+            uint64_t cur = 0;
+            for (int i = s; i < e; ++i) {
+                while (cur && G[s + 63 - __builtin_clzll(cur)] > G[i])
+                    cur &= ~(1ULL << (63 - __builtin_clzll(cur)));
+                pos_mask[i] = cur |= 1ULL << (i - s);
+            }
+            block_min_idx[bi] = s + __builtin_ctzll(pos_mask[e - 1]);
+        }
+    }
+
+    // index of the minimum of [l, r] inside block bi
+    int in_min(int bi, int l, int r) const {
+        return bi * B + __builtin_ctzll(pos_mask[bi * B + r] & (~0ULL << l));
+    }
+
+    void prefetch_in_block(int bi, int r) const {
+        __builtin_prefetch(&pos_mask[bi * B + r]);
+    }
+#else
+    // the short last block is padded with INT_MAX, which never pops anything
+    void build_in_block(int b0, int b1) {
+        const TypeTables &tt = typeTables();
+        for (int bi = b0; bi < b1; ++bi) {
+            int vals[B], stk[B], top = 0, t = 0, pushes = 0, pops = 0;
+            for (int i = 0, s = bi * B; i < B; ++i)
+                vals[i] = s + i < N ? G[s + i] : INT_MAX;
+            for (int i = 0; i < B; ++i) {
+                while (top > 0 && vals[stk[top - 1]] > vals[i])
+                    --top, t += tt.ballot[pushes + 1][pops++];
+                stk[top++] = i, ++pushes;
+            }
+            block_type[bi] = (unsigned short)t;
+            block_min_idx[bi] = bi * B + tt.in_block[t][0][B - 1];
+        }
+    }
+
+    // index of the minimum of [l, r] inside block bi
+    int in_min(int bi, int l, int r) const {
+        return bi * B + typeTables().in_block[block_type[bi]][l][r];
+    }
+
+    void prefetch_in_block(int bi, int) const {
+        __builtin_prefetch(&block_type[bi]);
+    }
+#endif
+
+public:
+    // threads actually used for a request: 0 means every core, and more
+    // threads than cores would only add start-up and time slicing
+    static int cap_threads(int threads) {
+        int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+        return threads <= 0 || threads > cores ? cores : threads;
+    }
+
+    RMQ() = default;
+    RMQ(const int *seq, int n, int threads = 1) { build(seq, n, threads); }
+    ~RMQ() { release(); }
+
+    RMQ(const RMQ &) = delete;
+    RMQ &operator=(const RMQ &) = delete;
+    RMQ(RMQ &&o) noexcept { swap(o); }
+    RMQ &operator=(RMQ &&o) noexcept {
+        RMQ tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+
+    void swap(RMQ &o) noexcept {
+        std::swap(G, o.G);
+        std::swap(N, o.N);
+        std::swap(nb, o.nb);
+        std::swap(K, o.K);
+        std::swap(arena, o.arena);
+        std::swap(arena_bytes, o.arena_bytes);
+        std::swap(used_bytes, o.used_bytes);
+        mapped.swap(o.mapped);
+        std::swap(build_sec, o.build_sec);
+        std::swap(block_min_idx, o.block_min_idx);
+        std::swap(log_2, o.log_2);
+        std::swap(st, o.st);
+#ifdef RMQ_STACK_MASKS
+        std::swap(pos_mask, o.pos_mask);
+#else
+        std::swap(block_type, o.block_type);
+#endif
+    }
+
+    // index seq[0..n) in O(n) on up to `threads` threads (0 = all cores);
+    // seq must outlive the structure
+    void build(const int *seq, int n, int threads = 1) {
+        auto t0 = std::chrono::steady_clock::now();
+        threads = cap_threads(threads);
+        G = seq;
+        N = n > 0 ? n : 0;
+        if (N == 0) return;
+        set_shape();
+        size_t bytes = used_bytes = layout(nullptr);
+        if (bytes > arena_bytes) {
+            release();
+            arena = ::operator new(bytes, std::align_val_t(64));
+            arena_bytes = bytes;
+        }
+        layout(static_cast<char*>(arena));
+
+        // blocks are independent: in-block data, block minima, level 0 and
+        // the log table are filled slice by slice.  A block's minimum is a
+        // by-product of its stack pass (the bottom of the final stack), so
+        // there is no separate per-block min reduction to vectorise; the
+        // SIMD work is the level fill.  cur[] carries the winning value next
+        // to each sparse-table cell, so the level fill below is a branchless
+        // select over contiguous arrays instead of two gathers through
+        // block_min_idx.
+        std::vector<int> cur(nb), nxt(nb);
+        parallel_for(nb, threads, [&](int lo, int hi) {
+            build_in_block(lo, hi);
+            for (int i = lo; i < hi; ++i) {
+                st[0][i] = i;
+                cur[i] = G[block_min_idx[i]];
+                log_2[i + 1] = 31 - __builtin_clz(i + 1);
+            }
+        });
+        for (int k = 1; k < K; ++k) {
+            int half = 1 << (k - 1), cnt = nb - (1 << k) + 1;
+            const int *px = st[k - 1], *pv = cur.data();
+            int *ox = st[k], *ov = nxt.data();
+            parallel_for(cnt, threads, [=](int lo, int hi) {
+                fill_level(px + lo, pv + lo, ox + lo, ov + lo, half, hi - lo);
+            });
+            cur.swap(nxt);
+        }
+        build_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    int size() const { return N; }
+
+    // wall time of the last build(), in seconds
+    double build_seconds() const { return build_sec; }
+
+    // write the index to path: one header page, then the arena as is
+    bool save(const char *path) const {
+        if (N == 0) return false;
+        size_t bytes = used_bytes;
+        IndexHeader h = {};
+        memcpy(h.magic, "D2RMQIDX", 8);
+        h.version = INDEX_VERSION, h.block = B;
+        h.n = N, h.nb = nb, h.k = K;
+        h.bytes = bytes;
+        h.checksum = checksum64(arena_data(), bytes);
+        h.data_checksum = checksum64(G, (size_t)N * sizeof(int));
+        std::vector<char> page(HEADER_BYTES, 0);
+        memcpy(page.data(), &h, sizeof h);
+        FILE *f = fopen(path, "wb");
+        if (!f) return false;
+        bool ok = fwrite(page.data(), 1, page.size(), f) == page.size()
+               && fwrite(arena_data(), 1, bytes, f) == bytes;
+        return fclose(f) == 0 && ok;
+    }
+
+    // map an index written by save() for seq[0..n) and query it in place:
+    // no copy and no rebuild.  verify rehashes the arena and seq against
+    // the header, which reads every page; without it only the header and
+    // sizes are checked.  On failure the instance is left empty.
+    bool load(const char *path, const int *seq, int n, bool verify = true) {
+        release();
+        G = nullptr, N = nb = K = 0;
+        MappedFile f;
+        if (!f.open(path) || f.size() < HEADER_BYTES) return false;
+        IndexHeader h;
+        memcpy(&h, f.data(), sizeof h);
+        if (memcmp(h.magic, "D2RMQIDX", 8) != 0 || h.version != INDEX_VERSION
+            || h.block != (uint32_t)B || h.n != n || n <= 0)
+            return false;
+        N = n;
+        set_shape();
+        size_t bytes = layout(nullptr);
+        if (h.nb != nb || h.k != K || h.bytes != bytes || f.size() < HEADER_BYTES + bytes
+            || (verify && (checksum64(f.data() + HEADER_BYTES, bytes) != h.checksum
+                           || checksum64(seq, (size_t)N * sizeof(int)) != h.data_checksum))) {
+            N = nb = K = 0;
+            return false;
+        }
+        used_bytes = layout(const_cast<char*>(f.data()) + HEADER_BYTES);
+        mapped.swap(f);
+        G = seq;
+        build_sec = 0;
+        return true;
+    }
+
+    // minimum of seq[L..R], or -1 for an invalid range
+    int query(int L, int R) const {
+        if (L < 0 || R < L || R >= N) return -1;
+        int bi = L / B, bj = R / B, si = bi * B, sj = bj * B;
+        if (bi == bj)
+            return G[in_min(bi, L - si, R - si)];
+        int ans = std::min(G[in_min(bi, L - si, B - 1)], G[in_min(bj, 0, R - sj)]);
+        if (bj - bi > 1) {
+            int l = bi + 1, r = bj - 1, len = r - l + 1, k = log_2[len];
+            int x = st[k][l], y = st[k][r - (1 << k) + 1];
+            int vx = G[block_min_idx[x]], vy = G[block_min_idx[y]];
+            ans = std::min(ans, vx <= vy ? vx : vy);
+        }
         return ans;
     }
-    int endL = (bi + 1) * B;
-    for (int i = L; i < endL; ++i)
-        ans = std::min(ans, G[i]);
-    int startR = bj * B;
-    for (int i = startR; i <= R; ++i)
-        ans = std::min(ans, G[i]);
-    if (bj - bi > 1) {
-        int l = bi + 1, r = bj - 1, len = r - l + 1, k = log_2[len];
-        int x = st[k][l], y = st[k][r - (1 << k) + 1];
-        int vx = G[block_min_idx[x]], vy = G[block_min_idx[y]];
-        ans = std::min(ans, vx <= vy ? vx : vy);
-    }
-    return ans;
+
+    // out[i] = query(Ls[i], Rs[i]) for i < q.  Queries run in groups of W
+    // through four stages; each stage issues the prefetches for the next
+    // one, so the dependent loads (sparse table → block minima → values)
+    // of W queries are in flight together instead of one after another.
+    void query_batch(const int *Ls, const int *Rs, int *out, size_t q) const {
+        const int W = 16;
+        for (size_t b = 0; b < q; b += W) {
+            int w = (int)std::min<size_t>(W, q - b);
+            int bi[W], bj[W], lo[W], hi[W], x[W], y[W], il[W], ir[W];
+            // 1) block indices; prefetch sparse-table cells and in-block data
+            for (int i = 0; i < w; ++i) {
+                int L = Ls[b + i], R = Rs[b + i];
+                if (L < 0 || R < L || R >= N) { bi[i] = -1; continue; }
+                bi[i] = L / B, bj[i] = R / B, lo[i] = L, hi[i] = R;
+                prefetch_in_block(bi[i], B - 1);
+                prefetch_in_block(bj[i], R - bj[i] * B);
+                if (bj[i] - bi[i] > 1) {
+                    int l = bi[i] + 1, len = bj[i] - 1 - l + 1;
+                    int k = 31 - __builtin_clz(len);
+                    __builtin_prefetch(&st[k][l]);
+                    __builtin_prefetch(&st[k][bj[i] - (1 << k)]);
+                }
+            }
+            // 2) sparse-table cells; prefetch block minima
+            for (int i = 0; i < w; ++i) {
+                x[i] = y[i] = -1;
+                if (bi[i] < 0 || bj[i] - bi[i] <= 1) continue;
+                int l = bi[i] + 1, len = bj[i] - 1 - l + 1;
+                int k = 31 - __builtin_clz(len);
+                x[i] = st[k][l], y[i] = st[k][bj[i] - (1 << k)];
+                __builtin_prefetch(&block_min_idx[x[i]]);
+                __builtin_prefetch(&block_min_idx[y[i]]);
+            }
+            // 3) in-block positions and block minima; prefetch the values
+            for (int i = 0; i < w; ++i) {
+                if (bi[i] < 0) continue;
+                int si = bi[i] * B, sj = bj[i] * B;
+                if (bi[i] == bj[i]) {
+                    il[i] = ir[i] = in_min(bi[i], lo[i] - si, hi[i] - si);
+                } else {
+                    il[i] = in_min(bi[i], lo[i] - si, B - 1);
+                    ir[i] = in_min(bj[i], 0, hi[i] - sj);
+                }
+                __builtin_prefetch(&G[il[i]]);
+                __builtin_prefetch(&G[ir[i]]);
+                if (x[i] >= 0) {
+                    x[i] = block_min_idx[x[i]], y[i] = block_min_idx[y[i]];
+                    __builtin_prefetch(&G[x[i]]);
+                    __builtin_prefetch(&G[y[i]]);
+                }
+            }
+            // 4) combine
+            for (int i = 0; i < w; ++i) {
+                if (bi[i] < 0) { out[b + i] = -1; continue; }
+                int ans = std::min(G[il[i]], G[ir[i]]);
+                if (x[i] >= 0) ans = std::min(ans, std::min(G[x[i]], G[y[i]]));
+                out[b + i] = ans;
+            }
+        }
+    }
+
+    // offline path: query_batch over contiguous slices on `threads` threads
+    void query_batch_parallel(const int *Ls, const int *Rs, int *out, size_t q,
+                              int threads) const {
+        threads = cap_threads(threads);
+        if (threads <= 1 || q < 4096) { query_batch(Ls, Rs, out, q); return; }
+        std::vector<std::thread> pool;
+        size_t per = (q + threads - 1) / threads;
+        for (size_t s = 0; s < q; s += per) {
+            size_t c = std::min(per, q - s);
+            pool.emplace_back([=] { query_batch(Ls + s, Rs + s, out + s, c); });
+        }
+        for (auto &t : pool) t.join();
+    }
+};
+
+#ifndef D2_B_LIBRARY
+// judge interface: one process-wide instance, rebuilt by every warm_up.
+// Other sources reuse the RMQ class with
+//   #define D2_B_LIBRARY
+//   #include "D2_B.cpp"
+// at file scope, which leaves this file self-contained for the judge.
+static RMQ rmq;
+
+// large arrays are built on every core; judge-sized inputs stay sequential
+void warm_up(int seq[], int n) {
+    rmq.build(seq, n, n >= (1 << 22) ? 0 : 1);
+}
+
+int query(int L, int R) {
+    return rmq.query(L, R);
+}
+#endif
+
+#ifdef D2_BUILD_BENCH
+// Build-time benchmark, sequential against parallel, and with a path the
+// cost of a restart from a saved index instead:
+//   g++ -O2 -std=c++17 -pthread -DD2_BUILD_BENCH D2_B.cpp
+//   ./a.out [n] [threads] [seed] [index path]
+#include <random>
+#include <string>
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 100000000;
+    int threads = argc > 2 ? atoi(argv[2]) : 0;
+    unsigned seed = argc > 3 ? (unsigned)atoi(argv[3]) : 1;
+    int asked = threads;
+    threads = RMQ::cap_threads(threads);
+
+    std::vector<int> a(n);
+    std::mt19937 rng(seed);
+    for (auto &x : a) x = (int)(rng() >> 1);
+
+    RMQ seq(a.data(), n, 1), par(a.data(), n, threads);
+    printf("n %d B %d\n", n, B);
+    printf("1 thread   build %.3f s  %.1f M elem/s\n", seq.build_seconds(),
+           n / seq.build_seconds() / 1e6);
+    printf("%d threads  build %.3f s  %.1f M elem/s  (asked %d, %u cores)\n", threads,
+           par.build_seconds(), n / par.build_seconds() / 1e6, asked,
+           std::thread::hardware_concurrency());
+
+    bool ok = true;
+    for (int q = 0; q < 1000000 && ok; ++q) {
+        int L = rng() % n, R = rng() % n;
+        if (L > R) std::swap(L, R);
+        ok = seq.query(L, R) == par.query(L, R);
+    }
+    printf("queries %s\n", ok ? "match" : "MISMATCH");
+
+    if (argc > 4 && ok) {
+        std::string idx = argv[4], arr = idx + ".array";
+        auto t0 = std::chrono::steady_clock::now();
+        ok = seq.save(idx.c_str()) && save_array(arr.c_str(), a.data(), n);
+        auto t1 = std::chrono::steady_clock::now();
+        MappedFile data(arr.c_str());
+        RMQ fast, checked;
+        ok = ok && data.count() == n && fast.load(idx.c_str(), data.ints(), n, false);
+        auto t2 = std::chrono::steady_clock::now();
+        ok = ok && checked.load(idx.c_str(), data.ints(), n, true);
+        auto t3 = std::chrono::steady_clock::now();
+        auto sec = [](auto x, auto y) { return std::chrono::duration<double>(y - x).count(); };
+        printf("save %.3f s  map %.6f s  map+verify %.3f s\n", sec(t0, t1), sec(t1, t2), sec(t2, t3));
+        for (int q = 0; q < 1000000 && ok; ++q) {
+            int L = rng() % n, R = rng() % n;
+            if (L > R) std::swap(L, R);
+            ok = seq.query(L, R) == fast.query(L, R);
+        }
+        printf("mapped queries %s\n", ok ? "match" : "MISMATCH");
+    }
+    return ok ? 0 : 1;
 }
+#endif
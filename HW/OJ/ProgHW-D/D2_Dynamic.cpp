@@ -0,0 +1,152 @@
+/* ProbId: D2-AB-Optimal-RMQ (dynamic variant with point updates) */
+
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+// Range-minimum queries with point updates.  The array is kept in blocks
+// of B contiguous values; block minima sit at the leaves of a bottom-up
+// segment tree stored in BFS (Eytzinger) order: node i has children 2i and
+// 2i+1 and the leaves are tree[leaves .. leaves + nb).  The tree is B times
+// smaller than the array, so its upper levels stay cached, and an update
+// rescans one block and walks one leaf-to-root path: O(B + log(n/B)).
+class DynamicRMQ {
+    static const int B = 16;
+
+    int N = 0, nb = 0, leaves = 1;
+    std::vector<int> val;               // own copy of the array
+    std::vector<int> tree;              // tree[leaves + b] = min of block b
+
+    int block_min(int b) const {
+        int s = b * B, e = std::min(N, s + B), m = INT_MAX;
+        for (int i = s; i < e; ++i) m = std::min(m, val[i]);
+        return m;
+    }
+
+public:
+    DynamicRMQ() = default;
+    DynamicRMQ(const int *seq, int n) { build(seq, n); }
+
+    // copy seq[0..n) and build in O(n)
+    void build(const int *seq, int n) {
+        N = std::max(n, 0);
+        val.assign(seq, seq + N);
+        nb = (N + B - 1) / B;
+        leaves = 1;
+        while (leaves < nb) leaves <<= 1;
+        tree.assign(2 * leaves, INT_MAX);
+        for (int b = 0; b < nb; ++b) tree[leaves + b] = block_min(b);
+        for (int i = leaves - 1; i >= 1; --i) tree[i] = std::min(tree[2 * i], tree[2 * i + 1]);
+    }
+
+    int size() const { return N; }
+
+    // seq[i] = value
+    void update(int i, int value) {
+        if (i < 0 || i >= N) return;
+        val[i] = value;
+        int p = leaves + i / B;
+        tree[p] = block_min(i / B);
+        for (p >>= 1; p >= 1; p >>= 1) {
+            int m = std::min(tree[2 * p], tree[2 * p + 1]);
+            if (tree[p] == m) break;    // nothing above changes
+            tree[p] = m;
+        }
+    }
+
+    // minimum of seq[L..R], or -1 for an invalid range (as the static RMQ)
+    int query(int L, int R) const {
+        if (L < 0 || R < L || R >= N) return -1;
+        int bi = L / B, bj = R / B, ans = INT_MAX;
+        if (bi == bj) {
+            for (int i = L; i <= R; ++i) ans = std::min(ans, val[i]);
+            return ans;
+        }
+        for (int i = L, e = (bi + 1) * B; i < e; ++i) ans = std::min(ans, val[i]);
+        for (int i = bj * B; i <= R; ++i) ans = std::min(ans, val[i]);
+        for (int l = bi + 1 + leaves, r = bj + leaves; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) ans = std::min(ans, tree[l++]);
+            if (r & 1) ans = std::min(ans, tree[--r]);
+        }
+        return ans;
+    }
+};
+
+// judge-style interface, as in D2_A/D2_B plus update()
+static DynamicRMQ drmq;
+
+void warm_up(int seq[], int n) {
+    drmq.build(seq, n);
+}
+
+int query(int L, int R) {
+    return drmq.query(L, R);
+}
+
+void update(int i, int value) {
+    drmq.update(i, value);
+}
+
+#ifdef D2_DYNAMIC_BENCH
+// Mixed read/write benchmark against rebuilding the static D2_B structure:
+//   g++ -O2 -std=c++17 -pthread -DD2_DYNAMIC_BENCH D2_Dynamic.cpp
+//   ./a.out [n] [ops] [update percent] [seed]
+// The static side rebuilds (warm_up) before any query that follows updates.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+#define D2_B_LIBRARY
+#include "D2_B.cpp"
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 100000;
+    int ops = argc > 2 ? atoi(argv[2]) : 20000;
+    int pct = argc > 3 ? atoi(argv[3]) : 10;
+    unsigned seed = argc > 4 ? (unsigned)atoi(argv[4]) : 1;
+
+    std::mt19937 rng(seed);
+    std::vector<int> a(n);
+    for (auto &x : a) x = (int)(rng() >> 1);
+    struct Op { bool upd; int x, y; };
+    std::vector<Op> seq(ops);
+    for (auto &op : seq) {
+        op.upd = (int)(rng() % 100) < pct;
+        int x = rng() % n, y = op.upd ? (int)(rng() >> 1) : (int)(rng() % n);
+        if (!op.upd && x > y) std::swap(x, y);
+        op = {op.upd, x, y};
+    }
+
+    using clk = std::chrono::steady_clock;
+    long long sumD = 0, sumS = 0;
+    int rebuilds = 0;
+
+    auto t0 = clk::now();
+    DynamicRMQ d(a.data(), n);
+    for (auto &op : seq) {
+        if (op.upd) d.update(op.x, op.y);
+        else sumD += d.query(op.x, op.y);
+    }
+    auto t1 = clk::now();
+
+    std::vector<int> b = a;
+    RMQ s(b.data(), n);
+    bool dirty = false;
+    for (auto &op : seq) {
+        if (op.upd) { b[op.x] = op.y; dirty = true; continue; }
+        if (dirty) { s.build(b.data(), n); dirty = false; rebuilds++; }
+        sumS += s.query(op.x, op.y);
+    }
+    auto t2 = clk::now();
+
+    double td = std::chrono::duration<double>(t1 - t0).count();
+    double ts = std::chrono::duration<double>(t2 - t1).count();
+    printf("n %d ops %d updates %d%%\n", n, ops, pct);
+    printf("dynamic  %.4f s  %.0f ops/s\n", td, ops / td);
+    printf("rebuild  %.4f s  %.0f ops/s  (%d rebuilds)\n", ts, ops / ts, rebuilds);
+    printf("checksum %s\n", sumD == sumS ? "match" : "MISMATCH");
+    return sumD == sumS ? 0 : 1;
+}
+#endif
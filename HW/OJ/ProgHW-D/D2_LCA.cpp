@@ -0,0 +1,319 @@
+/* ProbId: D2-AB-Optimal-RMQ (LCA front end) */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "rmq.hpp"
+
+// O(1) lowest common ancestors by RMQ over the Euler tour.  The tour lists
+// 2n - 1 nodes and neighbouring depths differ by exactly one, so a block of
+// B = 8 positions is its start depth plus 7 up/down bits, and one 8 KB
+// table over the 128 step patterns answers every in-block range: the ±1
+// case of the D2_B type tables.  Block minima go to a BlockRMQ (rmq.hpp),
+// and LCA(u, v) is the shallowest tour entry between the first visits of
+// u and v.
+class LCA {
+    static const int B = 8;
+    static const int NP = 1 << (B - 1);
+
+    struct StepTables {
+        signed char rel[NP][B];             // depth at offset i minus depth at 0
+        unsigned char in_block[NP][B][B];   // offset of the shallowest entry of [l, r]
+
+        StepTables() {
+            for (int p = 0; p < NP; ++p) {
+                rel[p][0] = 0;
+                for (int i = 1; i < B; ++i)
+                    rel[p][i] = (signed char)(rel[p][i - 1] + ((p >> (i - 1) & 1) ? -1 : 1));
+                for (int l = 0; l < B; ++l)
+                    for (int r = l, mi = l; r < B; ++r) {
+                        if (rel[p][r] < rel[p][mi]) mi = r;
+                        in_block[p][l][r] = (unsigned char)mi;
+                    }
+            }
+        }
+    };
+
+    static const StepTables &step_tables() {
+        static const StepTables tables;
+        return tables;
+    }
+
+    int n = 0;
+    size_t nb = 0;
+    std::vector<int> euler;             // node at each tour position
+    std::vector<int> first;             // first tour position of each node
+    std::vector<unsigned char> pattern; // bit i: step i -> i + 1 goes up
+    std::vector<int> start_depth;       // depth at each block start
+    std::vector<int> block_min;         // shallowest depth in each block
+    BlockRMQ<int> top;
+
+    int depth_at(size_t p) const {
+        return start_depth[p / B] + step_tables().rel[pattern[p / B]][p % B];
+    }
+
+    // tour position of the shallowest entry of [l, r] inside block b
+    size_t in_min(size_t b, int l, int r) const {
+        return b * B + step_tables().in_block[pattern[b]][l][r];
+    }
+
+    size_t pick(size_t a, size_t c) const { return depth_at(c) < depth_at(a) ? c : a; }
+
+    void clear() {
+        n = 0, nb = 0;
+        euler.clear(), first.clear(), pattern.clear();
+        start_depth.clear(), block_min.clear();
+    }
+
+public:
+    LCA() = default;
+    LCA(const int *parent, int n) { build(parent, n); }
+
+    // index the tree given by parent[v] (-1 at the single root) in O(n)
+    // with an explicit stack, so path-like trees of 10^8 nodes are fine;
+    // false (and an empty index) if parent[] is not a rooted tree
+    bool build(const int *parent, int count) {
+        clear();
+        if (count <= 0) return false;
+        // children in CSR form
+        std::vector<int> head(count + 1, 0), child(count - 1 > 0 ? count - 1 : 0);
+        int root = -1;
+        for (int v = 0; v < count; ++v) {
+            int p = parent[v];
+            if (p < 0) {
+                if (root >= 0) return false;
+                root = v;
+            } else if (p >= count) {
+                return false;
+            } else {
+                ++head[p + 1];
+            }
+        }
+        if (root < 0) return false;
+        for (int v = 0; v < count; ++v) head[v + 1] += head[v];
+        std::vector<int> cur(head.begin(), head.end() - 1);
+        for (int v = 0; v < count; ++v)
+            if (parent[v] >= 0) child[cur[parent[v]]++] = v;
+        std::copy(head.begin(), head.end() - 1, cur.begin());
+
+        size_t len = 2 * (size_t)count - 1;
+        nb = (len + B - 1) / B;
+        euler.assign(len, 0);
+        first.assign(count, -1);
+        pattern.assign(nb, 0);      // steps past the end stay "down"
+        start_depth.assign(nb, 0);
+        size_t t = 0;
+        int d = 0;
+        auto emit = [&](int v, bool up) {
+            if (t % B == 0) start_depth[t / B] = d;
+            else if (up) pattern[t / B] |= (unsigned char)(1 << (t % B - 1));
+            euler[t] = v;
+            if (first[v] < 0) first[v] = (int)t;
+            ++t;
+        };
+        std::vector<int> stk;
+        stk.push_back(root);
+        emit(root, false);
+        while (!stk.empty()) {
+            int u = stk.back();
+            if (cur[u] < head[u + 1]) {
+                int c = child[cur[u]++];
+                ++d, emit(c, false);
+                stk.push_back(c);
+            } else {
+                stk.pop_back();
+                if (!stk.empty()) --d, emit(stk.back(), true);
+            }
+            if (t > len) break;
+        }
+        // a cycle leaves nodes unreached
+        if (t != len) {
+            clear();
+            return false;
+        }
+        n = count;
+        const StepTables &tt = step_tables();
+        block_min.resize(nb);
+        for (size_t b = 0; b < nb; ++b)
+            block_min[b] = start_depth[b] + tt.rel[pattern[b]][tt.in_block[pattern[b]][0][B - 1]];
+        top.build(block_min.data(), nb);
+        return true;
+    }
+
+    int size() const { return n; }
+
+    // depth of v (the root has depth 0), or -1 for an invalid node
+    int depth(int v) const { return v < 0 || v >= n ? -1 : depth_at(first[v]); }
+
+    // lowest common ancestor of u and v, or -1 for an invalid node
+    int lca(int u, int v) const {
+        if (u < 0 || v < 0 || u >= n || v >= n) return -1;
+        size_t l = first[u], r = first[v];
+        if (l > r) std::swap(l, r);
+        size_t bl = l / B, br = r / B;
+        if (bl == br) return euler[in_min(bl, int(l % B), int(r % B))];
+        size_t best = pick(in_min(bl, int(l % B), B - 1), in_min(br, 0, int(r % B)));
+        if (br - bl > 1) best = pick(best, in_min(top.argmin(bl + 1, br - 1), 0, B - 1));
+        return euler[best];
+    }
+
+    // out[i] = lca(us[i], vs[i]) for i < q.  Groups of W queries go through
+    // three stages that prefetch the loads of the next one (first visits,
+    // then block data, then the tour entry), as in D2_B's query_batch; with
+    // threads > 1 contiguous slices run in parallel.
+    void lca_batch(const int *us, const int *vs, int *out, size_t q, int threads = 1) const {
+        if (threads > 1 && q >= 4096) {
+            std::vector<std::thread> pool;
+            size_t per = (q + threads - 1) / threads;
+            for (size_t s = 0; s < q; s += per) {
+                size_t c = std::min(per, q - s);
+                pool.emplace_back([=] { lca_batch(us + s, vs + s, out + s, c, 1); });
+            }
+            for (auto &t : pool) t.join();
+            return;
+        }
+        const int W = 16;
+        for (size_t b = 0; b < q; b += W) {
+            int w = (int)std::min<size_t>(W, q - b);
+            size_t l[W], r[W];
+            bool ok[W];
+            // 1) validate and prefetch the first visits
+            for (int i = 0; i < w; ++i) {
+                int u = us[b + i], v = vs[b + i];
+                ok[i] = u >= 0 && v >= 0 && u < n && v < n;
+                if (!ok[i]) continue;
+                __builtin_prefetch(&first[u]);
+                __builtin_prefetch(&first[v]);
+            }
+            // 2) tour range; prefetch both end blocks
+            for (int i = 0; i < w; ++i) {
+                if (!ok[i]) continue;
+                l[i] = first[us[b + i]], r[i] = first[vs[b + i]];
+                if (l[i] > r[i]) std::swap(l[i], r[i]);
+                __builtin_prefetch(&pattern[l[i] / B]);
+                __builtin_prefetch(&pattern[r[i] / B]);
+                __builtin_prefetch(&start_depth[l[i] / B]);
+                __builtin_prefetch(&start_depth[r[i] / B]);
+            }
+            // 3) shallowest position; prefetch its tour entry
+            for (int i = 0; i < w; ++i) {
+                if (!ok[i]) continue;
+                size_t bl = l[i] / B, br = r[i] / B;
+                if (bl == br) {
+                    l[i] = in_min(bl, int(l[i] % B), int(r[i] % B));
+                } else {
+                    size_t best = pick(in_min(bl, int(l[i] % B), B - 1), in_min(br, 0, int(r[i] % B)));
+                    if (br - bl > 1) best = pick(best, in_min(top.argmin(bl + 1, br - 1), 0, B - 1));
+                    l[i] = best;
+                }
+                __builtin_prefetch(&euler[l[i]]);
+            }
+            for (int i = 0; i < w; ++i) out[b + i] = ok[i] ? euler[l[i]] : -1;
+        }
+    }
+};
+
+// judge-style interface in the D2 manner: index a parent array once, then
+// answer lca() queries
+static LCA lca_index;
+
+void warm_up(int parent[], int n) {
+    lca_index.build(parent, n);
+}
+
+int lca(int u, int v) {
+    return lca_index.lca(u, v);
+}
+
+#ifdef D2_LCA_BENCH
+// Against binary lifting on a random tree where node i hangs below one of
+// the `span` nodes before it (0 = any earlier node, a shallow random
+// recursive tree; small spans give deep trees), with labels shuffled:
+//   g++ -O2 -std=c++17 -pthread -DD2_LCA_BENCH D2_LCA.cpp
+//   ./a.out [n] [queries] [span] [seed] [threads]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int q = argc > 2 ? atoi(argv[2]) : 5000000;
+    int span = argc > 3 ? atoi(argv[3]) : 0;
+    unsigned seed = argc > 4 ? (unsigned)atoi(argv[4]) : 1;
+    int threads = argc > 5 ? atoi(argv[5]) : 1;
+
+    std::mt19937 rng(seed);
+    std::vector<int> perm(n), parent(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), rng);
+    parent[perm[0]] = -1;
+    for (int i = 1; i < n; ++i) {
+        int lo = span > 0 ? std::max(0, i - span) : 0;
+        parent[perm[i]] = perm[lo + rng() % (i - lo)];
+    }
+    std::vector<int> us(q), vs(q), a(q), b(q);
+    for (int i = 0; i < q; ++i) us[i] = rng() % n, vs[i] = rng() % n;
+
+    using clk = std::chrono::steady_clock;
+    auto sec = [](auto x, auto y) { return std::chrono::duration<double>(y - x).count(); };
+
+    auto t0 = clk::now();
+    LCA idx(parent.data(), n);
+    auto t1 = clk::now();
+    for (int i = 0; i < q; ++i) a[i] = idx.lca(us[i], vs[i]);
+    auto t2 = clk::now();
+    idx.lca_batch(us.data(), vs.data(), b.data(), q, threads);
+    auto t3 = clk::now();
+    bool ok = a == b;
+
+    // binary lifting: up[k * n + v] is the 2^k-th ancestor; perm lists
+    // every node after its parent
+    int LOG = 1;
+    while ((1 << LOG) < n) ++LOG;
+    auto t4 = clk::now();
+    std::vector<int> up((size_t)LOG * n), dep(n);
+    for (int i = 0; i < n; ++i) {
+        int v = perm[i], p = parent[v];
+        up[v] = p < 0 ? v : p;
+        dep[v] = p < 0 ? 0 : dep[p] + 1;
+    }
+    for (int k = 1; k < LOG; ++k)
+        for (int v = 0; v < n; ++v)
+            up[(size_t)k * n + v] = up[(size_t)(k - 1) * n + up[(size_t)(k - 1) * n + v]];
+    auto t5 = clk::now();
+    int maxdep = 0;
+    for (int i = 0; i < q; ++i) {
+        int u = us[i], v = vs[i];
+        if (dep[u] < dep[v]) std::swap(u, v);
+        for (int k = LOG - 1; k >= 0; --k)
+            if (dep[u] - (1 << k) >= dep[v]) u = up[(size_t)k * n + u];
+        if (u != v) {
+            for (int k = LOG - 1; k >= 0; --k)
+                if (up[(size_t)k * n + u] != up[(size_t)k * n + v])
+                    u = up[(size_t)k * n + u], v = up[(size_t)k * n + v];
+            u = up[u];
+        }
+        b[i] = u;
+    }
+    auto t6 = clk::now();
+    ok = ok && a == b;
+    for (int v = 0; v < n; ++v) {
+        maxdep = std::max(maxdep, dep[v]);
+        ok = ok && idx.depth(v) == dep[v];
+    }
+
+    printf("n %d queries %d depth %d\n", n, q, maxdep);
+    printf("euler rmq   build %.3f s  query %.3f s  %.1f M q/s  batch %.3f s  %.1f M q/s\n",
+           sec(t0, t1), sec(t1, t2), q / sec(t1, t2) / 1e6, sec(t2, t3), q / sec(t2, t3) / 1e6);
+    printf("bin lifting build %.3f s  query %.3f s  %.1f M q/s\n",
+           sec(t4, t5), sec(t5, t6), q / sec(t5, t6) / 1e6);
+    printf("answers %s\n", ok ? "match" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+#endif
@@ -0,0 +1,297 @@
+/* ProbId: D2-AB-Optimal-RMQ (succinct variant, argmin without the values) */
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "rmq.hpp"
+
+// Range-minimum positions in about 2.8n bits, never reading the array
+// after build().  The array is kept only as the D1.cpp push/pop signature
+// of its Cartesian tree: scanning left to right, each element pops every
+// larger one off a stack ('1') and is then pushed ('0'); the 2n bits are
+// packed LSB first.  Let E(t) be pushes - pops over bits[0..t] (the stack
+// height) and p_i the position of i's push.  The leftmost minimum m of
+// [l, r] pops every element of [l, m) and stops at a height nothing in
+// [l, r] can go below, so with z the rightmost minimum of E over [p_l, p_r]:
+//   m = l                            if E(z) == E(p_l)
+//   m = number of pushes in [0, z]   otherwise (bit z + 1 is m's push)
+// p_i comes from select samples, and the minimum of E from a range min-max
+// tree with three levels: int8 minima per word, int minima per 512-bit
+// block, and a BlockRMQ over the block minima.
+// Space per element: 2 bits of signature, plus 0.25 for the word minima,
+// 0.25 for the block minima and pop counts, 0.25 for the BlockRMQ masks
+// and 0.06 for the select samples.  The blocks have a fixed size, so these
+// levels are a constant fraction of n, not o(n).
+// Query time: the rank and the min-excess walk are bounded word and byte
+// work, but each of the two selects binary-searches the blocks between two
+// samples.  Samples sit every 512 pushes, so they are 2 blocks apart on
+// average for any input, but one gap can hold a pop run of nearly n bits.
+// A query is therefore O(log n) in the worst case, not O(1).
+class SuccinctRMQ {
+    static const int WB = 8;            // words per block
+    static const int BB = 64 * WB;      // bits per block
+    static const int SAMPLE = 512;      // pushes per select sample
+
+    // per byte, LSB first: excess change, minimum prefix excess, the
+    // rightmost offset that reaches it, and the offset of the k-th push
+    struct ByteTable {
+        signed char tot[256], mn[256], pos[256], push[256][8];
+
+        ByteTable() {
+            for (int v = 0; v < 256; ++v) {
+                int e = 0, m = INT_MAX, at = 0, k = 0;
+                for (int i = 0; i < 8; ++i) {
+                    e += (v >> i & 1) ? -1 : 1;
+                    if (e <= m) m = e, at = i;
+                    if (!(v >> i & 1)) push[v][k++] = (signed char)i;
+                }
+                tot[v] = (signed char)e, mn[v] = (signed char)m, pos[v] = (signed char)at;
+            }
+        }
+    };
+
+    static const ByteTable &byte_table() {
+        static const ByteTable table;
+        return table;
+    }
+
+    int N = 0;
+    size_t nbits = 0, nblocks = 0;
+    std::vector<uint64_t> bits;         // 1 = pop, padded to whole blocks
+    std::vector<int8_t> word_min;       // min of E in a word, relative to its start
+    std::vector<int> block_min;         // min of E in a block
+    std::vector<uint32_t> block_pops;   // pops before each block
+    std::vector<uint32_t> push_sample;  // block holding push j * SAMPLE
+    BlockRMQ<int, std::less_equal<int>, 64> top;    // rightmost block minimum
+
+    // pops in bits[0, pos)
+    size_t pops_before(size_t pos) const {
+        size_t w = pos / 64, c = block_pops[pos / BB];
+        for (size_t v = pos / BB * WB; v < w; ++v) c += __builtin_popcountll(bits[v]);
+        if (pos % 64) c += __builtin_popcountll(bits[w] & ((1ULL << (pos % 64)) - 1));
+        return c;
+    }
+
+    // position of the k-th push, k >= 1; O(log) in the blocks between the
+    // two samples around it
+    size_t select_push(size_t k) const {
+        size_t j = (k - 1) / SAMPLE;
+        size_t lo = push_sample[j];
+        size_t hi = j + 1 < push_sample.size() ? push_sample[j + 1] : nblocks - 1;
+        // last block in [lo, hi] with fewer than k pushes before it
+        while (lo < hi) {
+            size_t mid = (lo + hi + 1) / 2;
+            if (mid * BB - block_pops[mid] < k) lo = mid;
+            else hi = mid - 1;
+        }
+        k -= lo * BB - block_pops[lo];
+        size_t w = lo * WB;
+        for (;; ++w) {
+            size_t z = 64 - __builtin_popcountll(bits[w]);
+            if (k <= z) break;
+            k -= z;
+        }
+        uint64_t v = bits[w];
+        int off = 0;
+        for (int c; (c = 8 - __builtin_popcount(v & 255)) < (int)k; v >>= 8, off += 8) k -= c;
+        return w * 64 + off + byte_table().push[v & 255][k - 1];
+    }
+
+    // walk the low len bits of x, starting at bit base with E = e before
+    // it, a byte at a time; keep the rightmost minimum in (best, at) and
+    // return E after the last bit.  Bits past len are cleared to pushes,
+    // which climb above the last real value and so never win.
+    static int scan_bits(uint64_t x, int len, int e, size_t base, int &best, size_t &at) {
+        const ByteTable &bt = byte_table();
+        if (len < 64) x &= (1ULL << len) - 1;
+        int end = e + len - 2 * __builtin_popcountll(x);
+        for (int i = 0; i < len; i += 8, x >>= 8) {
+            int v = x & 255;
+            if (e + bt.mn[v] <= best) best = e + bt.mn[v], at = base + i + bt.pos[v];
+            e += bt.tot[v];
+        }
+        return end;
+    }
+
+    // rightmost minimum of E over [x, y] inside one block, merged into
+    // (best, at); e is E before x
+    void scan_block(size_t x, size_t y, int e, int &best, size_t &at) const {
+        size_t w = x / 64, wy = y / 64;
+        if (x % 64) {
+            size_t end = w == wy ? y : w * 64 + 63;
+            e = scan_bits(bits[w] >> (x % 64), (int)(end - x + 1), e, x, best, at);
+            if (w++ == wy) return;
+        }
+        // whole words by their minima; only the last one that reaches the
+        // best so far is walked bit by bit
+        size_t last = y % 64 == 63 ? wy + 1 : wy, cand = SIZE_MAX;
+        int cand_e = 0;
+        for (; w < last; ++w) {
+            if (e + word_min[w] <= best) best = e + word_min[w], cand = w, cand_e = e;
+            e += 64 - 2 * __builtin_popcountll(bits[w]);
+        }
+        if (cand != SIZE_MAX) scan_bits(bits[cand], 64, cand_e, cand * 64, best, at);
+        if (w == wy && y % 64 != 63) scan_bits(bits[w], (int)(y % 64 + 1), e, w * 64, best, at);
+    }
+
+    // E before the first bit of block b
+    int block_start(size_t b) const { return (int)(b * BB - 2 * (size_t)block_pops[b]); }
+
+    // rightmost minimum of E over [x, y], with E = e before x; its value
+    // goes to best
+    size_t min_excess(size_t x, size_t y, int e, int &best) const {
+        best = INT_MAX;
+        size_t at = x, bx = x / BB, by = y / BB;
+        if (bx == by) {
+            scan_block(x, y, e, best, at);
+            return at;
+        }
+        scan_block(x, bx * BB + BB - 1, e, best, at);
+        if (by - bx > 1) {
+            size_t b = top.argmin(bx + 1, by - 1);
+            if (block_min[b] <= best) scan_block(b * BB, b * BB + BB - 1, block_start(b), best, at);
+        }
+        scan_block(by * BB, y, block_start(by), best, at);
+        return at;
+    }
+
+public:
+    SuccinctRMQ() = default;
+    SuccinctRMQ(const int *seq, int n) { build(seq, n); }
+
+    // encode seq[0..n) in O(n); seq is not needed afterwards
+    void build(const int *seq, int n) {
+        N = n > 0 ? n : 0;
+        nbits = 2 * (size_t)N;
+        nblocks = (nbits + BB - 1) / BB;
+        bits.assign(nblocks * WB, 0);
+        push_sample.clear();
+        std::vector<int> stk;
+        size_t t = 0;
+        for (int i = 0; i < N; ++i) {
+            while (!stk.empty() && stk.back() > seq[i]) {
+                stk.pop_back();
+                bits[t / 64] |= 1ULL << (t % 64), ++t;
+            }
+            if (i % SAMPLE == 0) push_sample.push_back((uint32_t)(t / BB));
+            stk.push_back(seq[i]), ++t;
+        }
+        for (; t < nbits; ++t) bits[t / 64] |= 1ULL << (t % 64);
+
+        const ByteTable &bt = byte_table();
+        word_min.assign(nblocks * WB, 0);
+        block_min.assign(nblocks, 0);
+        block_pops.assign(nblocks, 0);
+        int e = 0;
+        size_t pops = 0;
+        for (size_t b = 0; b < nblocks; ++b) {
+            block_pops[b] = (uint32_t)pops;
+            int bm = INT_MAX;
+            for (size_t w = b * WB; w < (b + 1) * WB; ++w) {
+                int we = 0, wm = INT_MAX;
+                uint64_t x = bits[w];
+                for (int k = 0; k < 8; ++k, x >>= 8) {
+                    wm = std::min(wm, we + bt.mn[x & 255]);
+                    we += bt.tot[x & 255];
+                }
+                word_min[w] = (int8_t)wm;
+                bm = std::min(bm, e + wm);
+                int p = __builtin_popcountll(bits[w]);
+                e += 64 - 2 * p, pops += p;
+            }
+            block_min[b] = bm;
+        }
+        top.build(block_min.data(), nblocks);
+    }
+
+    int size() const { return N; }
+
+    // memory held by the structure
+    size_t bytes() const {
+        return bits.size() * 8 + word_min.size() + block_min.size() * sizeof(int)
+             + (block_pops.size() + push_sample.size()) * sizeof(uint32_t) + top.bytes();
+    }
+
+    // leftmost position of the minimum of seq[L..R], or -1 for an invalid range
+    int argmin(int L, int R) const {
+        if (L < 0 || R < L || R >= N) return -1;
+        if (L == R) return L;
+        size_t pl = select_push(L + 1), pr = select_push(R + 1);
+        // L pushes and pl - L pops come before p_L
+        int e = (int)(2 * (size_t)L - pl), best;
+        size_t z = min_excess(pl, pr, e, best);
+        if (best == e + 1) return L;
+        return (int)(z + 1 - pops_before(z + 1));
+    }
+};
+
+// judge-style interface as in D2_A/D2_B; the succinct index answers the
+// position and the judge's array supplies the value
+static SuccinctRMQ srmq;
+static const int *sseq = nullptr;
+
+void warm_up(int seq[], int n) {
+    srmq.build(seq, n);
+    sseq = seq;
+}
+
+int query(int L, int R) {
+    int m = srmq.argmin(L, R);
+    return m < 0 ? -1 : sseq[m];
+}
+
+#ifdef D2_SUCCINCT_BENCH
+// Space and query time against BlockRMQ<int> (rmq.hpp), which also checks
+// every answer:
+//   g++ -O2 -std=c++17 -DD2_SUCCINCT_BENCH D2_Succinct.cpp
+//   ./a.out [n] [queries] [value range] [seed]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 10000000;
+    int q = argc > 2 ? atoi(argv[2]) : 5000000;
+    unsigned range = argc > 3 ? (unsigned)atoi(argv[3]) : 0;
+    unsigned seed = argc > 4 ? (unsigned)atoi(argv[4]) : 1;
+
+    std::mt19937 rng(seed);
+    std::vector<int> a(n);
+    for (auto &x : a) x = (int)(range ? rng() % range : rng() >> 1);
+    std::vector<int> Ls(q), Rs(q);
+    for (int i = 0; i < q; ++i) {
+        Ls[i] = rng() % n, Rs[i] = rng() % n;
+        if (Ls[i] > Rs[i]) std::swap(Ls[i], Rs[i]);
+    }
+
+    using clk = std::chrono::steady_clock;
+    auto sec = [](auto x, auto y) { return std::chrono::duration<double>(y - x).count(); };
+    auto t0 = clk::now();
+    SuccinctRMQ s(a.data(), n);
+    auto t1 = clk::now();
+    BlockRMQ<int> b(a.data(), n);
+    auto t2 = clk::now();
+
+    long long sumS = 0, sumB = 0;
+    bool ok = true;
+    auto t3 = clk::now();
+    for (int i = 0; i < q; ++i) sumS += s.argmin(Ls[i], Rs[i]);
+    auto t4 = clk::now();
+    for (int i = 0; i < q; ++i) sumB += (long long)b.argmin(Ls[i], Rs[i]);
+    auto t5 = clk::now();
+    for (int i = 0; i < q && ok; ++i) ok = s.argmin(Ls[i], Rs[i]) == (int)b.argmin(Ls[i], Rs[i]);
+
+    printf("n %d queries %d\n", n, q);
+    printf("succinct  %.2f bits/elem  build %.3f s  query %.3f s  %.1f M q/s\n",
+           8.0 * s.bytes() / n, sec(t0, t1), sec(t3, t4), q / sec(t3, t4) / 1e6);
+    printf("BlockRMQ  %.2f bits/elem  build %.3f s  query %.3f s  %.1f M q/s  (+32 bits/elem of data)\n",
+           8.0 * b.bytes() / n, sec(t1, t2), sec(t4, t5), q / sec(t4, t5) / 1e6);
+    printf("answers %s\n", ok && sumS == sumB ? "match" : "MISMATCH");
+    return ok && sumS == sumB ? 0 : 1;
+}
+#endif
@@ -0,0 +1,162 @@
+/* Generic block-decomposed RMQ: value type, comparator and block size are
+ * template parameters.
+ *
+ *   BlockRMQ<int>                              range min over int (B = 64)
+ *   BlockRMQ<long long, std::greater<long long>> range max
+ *   BlockRMQ<float, std::less<float>, 32>      range argmin over float keys
+ *
+ * Same layout as the D2 RMQ: blocks of B values answered in-block by
+ * per-position stack masks (D2_B -DRMQ_STACK_MASKS), and a sparse table
+ * over the blocks, all in one 64-byte-aligned arena.  The sparse table
+ * stores the winning array position directly, which saves the
+ * block_min_idx indirection of the int version.  Ties go to the leftmost
+ * position (std::less_equal, which pops equal values off the stacks,
+ * gives the rightmost), and the array must have fewer than 2^32 elements.
+ *
+ * This header is the RMQ for code that may include things (D2_LCA,
+ * D2_Succinct, the bench).  The judge files must stay single-file, so
+ * their int RMQ is copied instead: D2_A.cpp is the source, and sync_d2.py
+ * rewrites D2_C(A).cpp and the type tables in D2_B.cpp from it.
+ */
+#ifndef RMQ_HPP
+#define RMQ_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <class T, class Compare = std::less<T>, int B = 64>
+class BlockRMQ {
+    static_assert(B >= 1 && B <= 64, "in-block masks hold at most 64 positions");
+    using Mask = typename std::conditional<(B <= 32), std::uint32_t, std::uint64_t>::type;
+    static const int MAXK = 32;
+
+    const T *G = nullptr;
+    std::size_t N = 0, nb = 0;
+    int K = 0;
+    Compare cmp;
+    void *arena = nullptr;
+    std::size_t arena_bytes = 0;
+    Mask *pos_mask = nullptr;           // stack of the block after pushing i
+    std::uint32_t *st[MAXK] = {};       // st[k][b]: argmin over blocks b..b+2^k-1
+
+    static std::size_t align_up(std::size_t x) { return (x + 63) & ~std::size_t(63); }
+
+    static int floor_log2(std::size_t x) { return 63 - __builtin_clzll(x); }
+
+    static int lowest(Mask m) {
+        return sizeof(Mask) == 4 ? __builtin_ctz((unsigned)m) : __builtin_ctzll(m);
+    }
+
+    static int highest(Mask m) {
+        return sizeof(Mask) == 4 ? 31 - __builtin_clz((unsigned)m) : 63 - __builtin_clzll(m);
+    }
+
+    // the better of two positions, the first one on ties
+    std::size_t pick(std::size_t a, std::size_t b) const {
+        return cmp(G[b], G[a]) ? b : a;
+    }
+
+    // position of the best element of [l, r] inside block bi
+    std::size_t in_block(std::size_t bi, int l, int r) const {
+        return bi * B + lowest(pos_mask[bi * B + r] & (Mask(~Mask(0)) << l));
+    }
+
+    void release() {
+        if (arena) ::operator delete(arena, std::align_val_t(64));
+        arena = nullptr;
+        arena_bytes = 0;
+    }
+
+public:
+    BlockRMQ(Compare c = Compare()) : cmp(c) {}
+    BlockRMQ(const T *data, std::size_t n, Compare c = Compare()) : cmp(c) { build(data, n); }
+    ~BlockRMQ() { release(); }
+
+    BlockRMQ(const BlockRMQ &) = delete;
+    BlockRMQ &operator=(const BlockRMQ &) = delete;
+    BlockRMQ(BlockRMQ &&o) noexcept { swap(o); }
+    BlockRMQ &operator=(BlockRMQ &&o) noexcept {
+        BlockRMQ tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+
+    void swap(BlockRMQ &o) noexcept {
+        std::swap(G, o.G);
+        std::swap(N, o.N);
+        std::swap(nb, o.nb);
+        std::swap(K, o.K);
+        std::swap(cmp, o.cmp);
+        std::swap(arena, o.arena);
+        std::swap(arena_bytes, o.arena_bytes);
+        std::swap(pos_mask, o.pos_mask);
+        std::swap(st, o.st);
+    }
+
+    // index data[0..n) in O(n); data must outlive the structure
+    void build(const T *data, std::size_t n) {
+        G = data;
+        N = n;
+        if (N == 0) return;
+        nb = (N + B - 1) / B;
+        K = floor_log2(nb) + 1;
+
+        std::size_t off_st[MAXK];
+        std::size_t off = align_up(N * sizeof(Mask));
+        for (int k = 0; k < K; ++k) {
+            off_st[k] = off;
+            off = align_up(off + (nb - (std::size_t(1) << k) + 1) * sizeof(std::uint32_t));
+        }
+        if (off > arena_bytes) {
+            release();
+            arena = ::operator new(off, std::align_val_t(64));
+            arena_bytes = off;
+        }
+        char *base = static_cast<char*>(arena);
+        pos_mask = reinterpret_cast<Mask*>(base);
+        for (int k = 0; k < K; ++k) st[k] = reinterpret_cast<std::uint32_t*>(base + off_st[k]);
+
+        // in-block stacks; level 0 is the block argmin
+        for (std::size_t bi = 0; bi < nb; ++bi) {
+            std::size_t s = bi * B, e = s + B < N ? s + B : N;
+            Mask cur = 0;
+            for (std::size_t i = s; i < e; ++i) {
+                while (cur && cmp(G[i], G[s + highest(cur)]))
+                    cur &= ~(Mask(1) << highest(cur));
+                pos_mask[i] = cur |= Mask(1) << (i - s);
+            }
+            st[0][bi] = (std::uint32_t)(s + lowest(pos_mask[e - 1]));
+        }
+        for (int k = 1; k < K; ++k) {
+            std::size_t half = std::size_t(1) << (k - 1);
+            for (std::size_t i = 0; i + 2 * half <= nb; ++i)
+                st[k][i] = (std::uint32_t)pick(st[k - 1][i], st[k - 1][i + half]);
+        }
+    }
+
+    std::size_t size() const { return N; }
+
+    // memory held by the index, not counting the data
+    std::size_t bytes() const { return arena_bytes; }
+
+    // leftmost position of the best element of data[L..R]; needs L ≤ R < size()
+    std::size_t argmin(std::size_t L, std::size_t R) const {
+        std::size_t bi = L / B, bj = R / B;
+        if (bi == bj) return in_block(bi, int(L - bi * B), int(R - bi * B));
+        std::size_t best = in_block(bi, int(L - bi * B), B - 1);
+        if (bj - bi > 1) {
+            int k = floor_log2(bj - bi - 1);
+            best = pick(best, pick(st[k][bi + 1], st[k][bj - (std::size_t(1) << k)]));
+        }
+        return pick(best, in_block(bj, 0, int(R - bj * B)));
+    }
+
+    // best value of data[L..R]; needs L ≤ R < size()
+    const T &min(std::size_t L, std::size_t R) const { return G[argmin(L, R)]; }
+};
+
+#endif
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Keep the D2 judge files in sync with D2_A.cpp.
+
+The judge takes each solution as one self-contained file, so the D2 RMQ
+code is copied rather than included.  D2_A.cpp is the one place to edit:
+
+  D2_C(A).cpp   is D2_A.cpp verbatim (same solution, second judge slot)
+  D2_B.cpp      takes the Fischer-Heun type tables, the region between
+                the "shared d2-type-tables" markers; its RMQ class is its
+                own (parallel build, batching, stack masks, saved index)
+
+  python3 sync_d2.py           rewrite the copies
+  python3 sync_d2.py --check   exit 1 if a copy differs from D2_A.cpp
+"""
+import os
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SOURCE = "D2_A.cpp"
+WHOLE = ["D2_C(A).cpp"]
+REGION = ["D2_B.cpp"]
+NAME = "shared d2-type-tables"
+
+
+def read(name):
+    with open(os.path.join(HERE, name)) as f:
+        return f.read()
+
+
+# text strictly between the begin marker line and the end marker line
+def region(text, name):
+    begin = text.find("// ---- " + NAME)
+    end = text.find("// ---- end " + NAME)
+    if begin < 0 or end < begin:
+        sys.exit("%s: no %s region" % (name, NAME))
+    begin = text.index("\n", begin) + 1
+    return begin, end
+
+
+def main():
+    check = sys.argv[1:] == ["--check"]
+    if sys.argv[1:] and not check:
+        sys.exit("usage: sync_d2.py [--check]")
+    src = read(SOURCE)
+    b, e = region(src, SOURCE)
+    shared = src[b:e]
+
+    wanted = {name: src for name in WHOLE}
+    for name in REGION:
+        text = read(name)
+        b, e = region(text, name)
+        wanted[name] = text[:b] + shared + text[e:]
+
+    stale = [name for name, text in wanted.items() if read(name) != text]
+    for name in stale:
+        if check:
+            print("%s is out of sync with %s" % (name, SOURCE))
+        else:
+            with open(os.path.join(HERE, name), "w") as f:
+                f.write(wanted[name])
+            print("updated %s" % name)
+    return 1 if check and stale else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
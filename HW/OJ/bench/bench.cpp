@@ -0,0 +1,688 @@
+/* Benchmark suite for the OJ solvers.
+ *
+ * Every problem family gets seeded workload generators, and every case
+ * prints one JSON line: wall time of the solver (generation excluded),
+ * throughput, peak RSS and a result checksum, so runs of two versions can
+ * be diffed for both speed and answers.
+ *
+ *   g++ -O2 -std=c++17 -pthread -DBENCH_VERSION="\"$(git rev-parse --short HEAD)\"" \
+ *       HW/OJ/bench/bench.cpp -o ojbench
+ *   ./ojbench [--filter=SUBSTR] [--scale=F] [--seed=S] [--list] > run.jsonl
+ *
+ * --scale multiplies the work of every case (1 = about a second each).  Each
+ * case runs in a forked child, so peak_rss_kb is that case's own high-water
+ * mark.  The solvers are the OJ sources themselves, each included in its
+ * own namespace so their globals and mains stay apart; D2_B.cpp is included
+ * at file scope in its library mode, without the judge interface.
+ */
+#include <bits/stdc++.h>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// at file scope first: BlockRMQ is benchmarked directly, and D2_Succinct
+// and D2_LCA (namespaced below) share this one definition of it
+#include "../ProgHW-D/rmq.hpp"
+#include "../fastio.hpp"
+#include "../solver_stats.hpp"
+
+// the D2_B RMQ class without its judge interface
+#define D2_B_LIBRARY
+#include "../ProgHW-D/D2_B.cpp"
+
+namespace a1 {
+#include "../A1.cpp"
+}
+namespace a3 {
+#include "../A3.cpp"
+}
+namespace b1 {
+#include "../B1.cpp"
+}
+namespace c4 {
+#include "../C4.cpp"
+}
+namespace d1 {
+#include "../ProgHW-D/D1.cpp"
+}
+namespace d2dyn {
+#include "../ProgHW-D/D2_Dynamic.cpp"
+}
+namespace d2succ {
+#include "../ProgHW-D/D2_Succinct.cpp"
+}
+namespace d2lca {
+#include "../ProgHW-D/D2_LCA.cpp"
+}
+
+#ifndef BENCH_VERSION
+#define BENCH_VERSION "dev"
+#endif
+
+using std::string;
+using std::vector;
+using ll = long long;
+using Rng = std::mt19937_64;
+using Edges = vector<std::pair<int, int>>;
+
+// ---------- workload generators ----------
+namespace gen {
+
+// m edges between L left vertices and R right vertices (ids L..L+R-1)
+Edges bipartite_random(int L, int R, ll m, Rng &rng) {
+    Edges e(m);
+    for (auto &x : e) x = {(int)(rng() % L), L + (int)(rng() % R)};
+    return e;
+}
+
+// rank k is drawn with probability proportional to k^-alpha
+struct PowerLaw {
+    vector<double> cdf;
+    PowerLaw(int n, double alpha) : cdf(n) {
+        double s = 0;
+        for (int k = 0; k < n; ++k) cdf[k] = s += std::pow(k + 1.0, -alpha);
+        for (auto &x : cdf) x /= s;
+    }
+    int operator()(Rng &rng) const {
+        double u = std::uniform_real_distribution<double>(0, 1)(rng);
+        return (int)(std::lower_bound(cdf.begin(), cdf.end() - 1, u) - cdf.begin());
+    }
+};
+
+// both sides power-law: a few hubs hold most edges
+Edges bipartite_powerlaw(int L, int R, ll m, double alpha, Rng &rng) {
+    PowerLaw pl(L, alpha), pr(R, alpha);
+    Edges e(m);
+    for (auto &x : e) x = {pl(rng), L + pr(rng)};
+    return e;
+}
+
+// general graph without self loops
+Edges general_random(int n, ll m, Rng &rng) {
+    Edges e(m);
+    for (auto &x : e) {
+        int u = rng() % n, v = rng() % (n - 1);
+        x = {u, v < u ? v : v + 1};
+    }
+    return e;
+}
+
+// n x n assignment costs, uniform in [0, 10^6)
+vector<ll> cost_dense(int n, Rng &rng) {
+    vector<ll> c((size_t)n * n);
+    for (auto &x : c) x = (ll)(rng() % 1000000);
+    return c;
+}
+
+// workers and jobs are random points in a square; cost = rounded distance
+vector<ll> cost_geometric(int n, Rng &rng) {
+    std::uniform_real_distribution<double> u(0, 10000);
+    vector<double> px(2 * n), py(2 * n);
+    for (int i = 0; i < 2 * n; ++i) px[i] = u(rng), py[i] = u(rng);
+    vector<ll> c((size_t)n * n);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            c[(size_t)i * n + j] = std::llround(std::hypot(px[i] - px[n + j], py[i] - py[n + j]));
+    return c;
+}
+
+struct FlowNet {
+    int n, s, t;
+    vector<std::tuple<int, int, ll>> edges;     // undirected, as C4's input
+};
+
+// s, `layers` layers of `width` nodes, t; every node links to `deg`
+// random nodes of the next layer
+FlowNet flow_layered(int layers, int width, int deg, Rng &rng) {
+    FlowNet f{layers * width + 2, layers * width, layers * width + 1, {}};
+    for (int i = 0; i < width; ++i) {
+        f.edges.emplace_back(f.s, i, 1 + rng() % 100);
+        f.edges.emplace_back((layers - 1) * width + i, f.t, 1 + rng() % 100);
+    }
+    for (int l = 0; l + 1 < layers; ++l)
+        for (int i = 0; i < width; ++i)
+            for (int k = 0; k < deg; ++k)
+                f.edges.emplace_back(l * width + i, (l + 1) * width + (int)(rng() % width),
+                                     1 + rng() % 100);
+    return f;
+}
+
+// W x H 4-neighbour grid with segmentation-style terminal links: s and t
+// are nodes W*H and W*H+1
+FlowNet flow_grid(int W, int H, Rng &rng) {
+    int N = W * H;
+    FlowNet f{N + 2, N, N + 1, {}};
+    for (int u = 0; u < N; ++u) {
+        int x = u % W;
+        f.edges.emplace_back(f.s, u, rng() % 64);
+        f.edges.emplace_back(u, f.t, rng() % 64);
+        if (x + 1 < W) f.edges.emplace_back(u, u + 1, 1 + rng() % 32);
+        if (u + W < N) f.edges.emplace_back(u, u + W, 1 + rng() % 32);
+    }
+    return f;
+}
+
+// random: uniform values; sorted: ascending; sawtooth: ascending runs of
+// 4093 that each end below everything so far, so every drop pops a whole
+// stack; the odd period puts the drops inside blocks of any power-of-two
+// or D2 size
+vector<int> rmq_array(size_t n, const string &kind, Rng &rng) {
+    vector<int> a(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (kind == "sorted") a[i] = (int)i;
+        else if (kind == "sawtooth") a[i] = (int)(i % 4093) - (int)(i / 4093) * 4093;
+        else a[i] = (int)(rng() >> 33);
+    }
+    return a;
+}
+
+// rooted tree as a parent array (root 0): random attaches every node to a
+// uniform earlier one (depth about ln n), path is a single chain (depth n)
+vector<int> tree_parents(int n, const string &kind, Rng &rng) {
+    vector<int> p(n);
+    p[0] = -1;
+    for (int i = 1; i < n; ++i) p[i] = kind == "path" ? i - 1 : (int)(rng() % i);
+    return p;
+}
+
+}  // namespace gen
+
+// ---------- cases ----------
+struct Outcome {
+    double wall = 0;        // solver seconds
+    double items = 0;       // work units processed in `wall`
+    const char *unit = "";
+    ll check = 0;           // result checksum
+    string size;            // problem dimensions
+};
+
+struct Case {
+    const char *name, *gen;
+    std::function<Outcome(double scale, Rng &rng)> run;
+};
+
+template <class F>
+static double timed(F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static int scaled(double base, double scale, double power = 1) {
+    return std::max(2, (int)(base * std::pow(scale, power)));
+}
+
+static string dims(std::initializer_list<std::pair<const char*, ll>> kv) {
+    string s;
+    for (auto &p : kv) s += (s.empty() ? "" : " ") + string(p.first) + "=" + std::to_string(p.second);
+    return s;
+}
+
+static Outcome run_konig(const Edges &e, int n) {
+    Outcome o;
+    a1::BipartiteMatchingKonig solver(n);
+    o.wall = timed([&] {
+        solver.buildGraph(e);
+        solver.solve();
+    });
+    o.check = solver.getMaxMatchingSize();
+    o.items = (double)e.size(), o.unit = "edges/s";
+    o.size = dims({{"n", n}, {"m", (ll)e.size()}});
+    return o;
+}
+
+// A3 keeps its graph in globals sized MAXN, so one solve is too short to
+// time alone; it is repeated `reps` times from scratch
+static Outcome run_blossom(const Edges &e, int n, int reps) {
+    Outcome o;
+    n = std::min(n, a3::MAXN - 1);
+    int res = 0;
+    o.wall = timed([&] {
+        for (int r = 0; r < reps; ++r) {
+            res = 0;
+            a3::n = n;
+            for (int i = 0; i < n; ++i) a3::g[i].clear();
+            for (auto &x : e) {
+                if (x.first >= n || x.second >= n) continue;
+                a3::g[x.first].push_back(x.second);
+                a3::g[x.second].push_back(x.first);
+            }
+            std::fill(a3::match, a3::match + n, -1);
+            for (int i = 0; i < n; ++i)
+                if (a3::match[i] == -1) res += a3::findPath(i);
+        }
+    });
+    o.check = res;
+    o.items = (double)e.size() * reps, o.unit = "edges/s";
+    o.size = dims({{"n", n}, {"m", (ll)e.size()}, {"reps", reps}});
+    return o;
+}
+
+static Outcome run_hungarian(const vector<ll> &c, int n) {
+    Outcome o;
+    b1::Hungarian h(n);
+    o.wall = timed([&] {
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) h.setCost(i, j, c[(size_t)i * n + j]);
+        o.check = h.solve();
+    });
+    o.items = (double)n * n, o.unit = "cells/s";
+    o.size = dims({{"n", n}});
+    return o;
+}
+
+static Outcome run_maxflow(const gen::FlowNet &f, c4::FlowEngine engine, bool scaling) {
+    Outcome o;
+    c4::MaxFlow mf(f.n);
+    o.wall = timed([&] {
+        for (auto &e : f.edges) {
+            mf.addEdge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+            mf.addEdge(std::get<1>(e), std::get<0>(e), std::get<2>(e));
+        }
+        o.check = mf.maxFlow(f.s, f.t, engine, scaling);
+    });
+    o.items = (double)f.edges.size(), o.unit = "edges/s";
+    o.size = dims({{"n", f.n}, {"m", (ll)f.edges.size()}});
+    return o;
+}
+
+// the same grid network through C4's implicit GridGraph and BK
+static Outcome run_bk_grid(const gen::FlowNet &f, int W, int H) {
+    Outcome o;
+    c4::GridGraph g(W, H);
+    o.wall = timed([&] {
+        vector<ll> cs(W * H, 0), ct(W * H, 0);
+        for (auto &e : f.edges) {
+            int u = std::get<0>(e), v = std::get<1>(e);
+            ll c = std::get<2>(e);
+            if (u == f.s) cs[v] = c;
+            else if (v == f.t) ct[u] = c;
+            else {
+                int d = v == u + 1 ? 0 : 2;
+                g.setEdge(u, d, c), g.setEdge(v, d ^ 1, c);
+            }
+        }
+        for (int u = 0; u < W * H; ++u) g.setTerminal(u, cs[u], ct[u]);
+        c4::BoykovKolmogorov<c4::GridGraph> bk(g);
+        o.check = bk.maxFlow(g.source(), g.sink());
+    });
+    o.items = (double)f.edges.size(), o.unit = "edges/s";
+    o.size = dims({{"W", W}, {"H", H}, {"m", (ll)f.edges.size()}});
+    return o;
+}
+
+static Outcome run_d1(const vector<int> &a32, int k) {
+    Outcome o;
+    vector<long long> a(a32.begin(), a32.end());
+    int blocks = (int)(a.size() / k);
+    string out;
+    d1::Encoder enc(k, d1::Format::Bits, true);
+    o.wall = timed([&] {
+        for (int b = 0; b < blocks; b += 1024)
+            enc.encode(a.data() + (size_t)b * k, std::min(1024, blocks - b), out);
+    });
+    o.check = (ll)std::hash<string>()(out);
+    o.items = (double)blocks * k, o.unit = "elems/s";
+    o.size = dims({{"n", (ll)blocks * k}, {"k", k}});
+    return o;
+}
+
+static Outcome run_d2_build(const vector<int> &a) {
+    Outcome o;
+    RMQ r;
+    o.wall = timed([&] { r.build(a.data(), (int)a.size()); });
+    o.check = r.query(0, (int)a.size() - 1);
+    o.items = (double)a.size(), o.unit = "elems/s";
+    o.size = dims({{"n", (ll)a.size()}});
+    return o;
+}
+
+static Outcome run_d2_query(const vector<int> &a, int q, Rng &rng) {
+    Outcome o;
+    int n = (int)a.size();
+    RMQ r(a.data(), n);
+    vector<int> Ls(q), Rs(q), out(q);
+    for (int i = 0; i < q; ++i) {
+        Ls[i] = rng() % n, Rs[i] = rng() % n;
+        if (Ls[i] > Rs[i]) std::swap(Ls[i], Rs[i]);
+    }
+    o.wall = timed([&] { r.query_batch(Ls.data(), Rs.data(), out.data(), q); });
+    for (int x : out) o.check += x;
+    o.items = q, o.unit = "queries/s";
+    o.size = dims({{"n", n}, {"q", q}});
+    return o;
+}
+
+// q random ranges, left <= right, below n
+static void random_ranges(int n, int q, Rng &rng, vector<int> &Ls, vector<int> &Rs) {
+    Ls.resize(q), Rs.resize(q);
+    for (int i = 0; i < q; ++i) {
+        Ls[i] = rng() % n, Rs[i] = rng() % n;
+        if (Ls[i] > Rs[i]) std::swap(Ls[i], Rs[i]);
+    }
+}
+
+// generic BlockRMQ<int> (rmq.hpp), build plus one query per range
+static Outcome run_block_rmq(const vector<int> &a, int q, Rng &rng) {
+    Outcome o;
+    int n = (int)a.size();
+    vector<int> Ls, Rs;
+    random_ranges(n, q, rng, Ls, Rs);
+    BlockRMQ<int> r;
+    o.wall = timed([&] {
+        r.build(a.data(), a.size());
+        for (int i = 0; i < q; ++i) o.check += r.min(Ls[i], Rs[i]);
+    });
+    o.items = q, o.unit = "queries/s";
+    o.size = dims({{"n", n}, {"q", q}, {"index_bytes", (ll)r.bytes()}});
+    return o;
+}
+
+// succinct RMQ: build from the array, then argmin without it
+static Outcome run_succinct(const vector<int> &a, int q, Rng &rng) {
+    Outcome o;
+    int n = (int)a.size();
+    vector<int> Ls, Rs;
+    random_ranges(n, q, rng, Ls, Rs);
+    d2succ::SuccinctRMQ r;
+    o.wall = timed([&] {
+        r.build(a.data(), n);
+        for (int i = 0; i < q; ++i) o.check += a[r.argmin(Ls[i], Rs[i])];
+    });
+    o.items = q, o.unit = "queries/s";
+    o.size = dims({{"n", n}, {"q", q}, {"index_bytes", (ll)r.bytes()}});
+    return o;
+}
+
+// DynamicRMQ under a mixed stream: `pct` percent point updates, the rest
+// range queries
+static Outcome run_dynamic(const vector<int> &a, int ops, int pct, Rng &rng) {
+    Outcome o;
+    int n = (int)a.size();
+    struct Op { bool upd; int x, y; };
+    vector<Op> seq(ops);
+    for (auto &op : seq) {
+        op.upd = (int)(rng() % 100) < pct;
+        op.x = rng() % n;
+        op.y = op.upd ? (int)(rng() >> 33) : (int)(rng() % n);
+        if (!op.upd && op.x > op.y) std::swap(op.x, op.y);
+    }
+    d2dyn::DynamicRMQ r(a.data(), n);
+    o.wall = timed([&] {
+        for (auto &op : seq) {
+            if (op.upd) r.update(op.x, op.y);
+            else o.check += r.query(op.x, op.y);
+        }
+    });
+    o.items = ops, o.unit = "ops/s";
+    o.size = dims({{"n", n}, {"ops", ops}, {"update_pct", pct}});
+    return o;
+}
+
+// LCA index build plus a batch of random pairs
+static Outcome run_lca(const vector<int> &parent, int q, Rng &rng) {
+    Outcome o;
+    int n = (int)parent.size();
+    vector<int> us(q), vs(q), out(q);
+    for (int i = 0; i < q; ++i) us[i] = rng() % n, vs[i] = rng() % n;
+    d2lca::LCA l;
+    o.wall = timed([&] {
+        if (!l.build(parent.data(), n)) _exit(1);
+        l.lca_batch(us.data(), vs.data(), out.data(), q);
+    });
+    for (int x : out) o.check += x;
+    o.items = q, o.unit = "queries/s";
+    o.size = dims({{"n", n}, {"q", q}});
+    return o;
+}
+
+// C4's global min cut on an undirected graph with weights in [1, 100]
+static Outcome run_global_min_cut(const Edges &e, int n, int trials, Rng &rng) {
+    Outcome o;
+    c4::GlobalMinCut g(n);
+    for (auto &x : e) g.addEdge(x.first, x.second, 1 + (ll)(rng() % 100));
+    o.wall = timed([&] {
+        o.check = trials ? g.kargerStein(trials, 1).first : g.stoerWagner().first;
+    });
+    o.items = (double)e.size(), o.unit = "edges/s";
+    o.size = dims({{"n", n}, {"m", (ll)e.size()}, {"trials", trials}});
+    return o;
+}
+
+// C4's cut sparsifier; check is the estimate, size carries the certified
+// interval around the exact flow
+static Outcome run_sparsifier(const gen::FlowNet &f, double eps) {
+    Outcome o;
+    c4::CutSparsifier sp(f.n);
+    for (auto &e : f.edges) sp.addEdge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+    c4::SparsifiedFlow r{};
+    o.wall = timed([&] { r = sp.maxFlow(f.s, f.t, eps); });
+    o.check = r.value;
+    o.items = (double)f.edges.size(), o.unit = "edges/s";
+    o.size = dims({{"n", f.n}, {"m", (ll)f.edges.size()}, {"kept", (ll)r.edges},
+                   {"lower", r.lowerBound}, {"upper", r.cutCapacity}});
+    return o;
+}
+
+// FastInput over a pipe: a forked writer sends integers whose first byte
+// lands just before a 64 KiB or 4 MiB boundary, after separator runs long
+// enough to drain the lookahead, and writes in pieces cut at those
+// boundaries; any token parsed in two halves exits the case with status 1
+static Outcome run_fastio_pipe(int boundaries, Rng &rng) {
+    Outcome o;
+    string s;
+    vector<ll> want;
+    for (int b = 1; b <= boundaries; ++b) {
+        size_t at = (size_t)b << 16;
+        if (b % 64 == 0) at = (size_t)(b / 64) << 22;
+        if (at <= s.size() + 1) continue;
+        size_t start = at - 1 - rng() % 20;
+        if (start <= s.size()) start = s.size() + 1;
+        while (s.size() < start) s += " \n\t "[rng() % 4];
+        ll v = (ll)(rng() >> 1) >> (rng() % 63);
+        if (rng() & 1) v = -v;
+        want.push_back(v);
+        s += std::to_string(v);
+    }
+    int fd[2];
+    if (pipe(fd) != 0) _exit(1);
+    pid_t writer = fork();
+    if (writer == 0) {
+        close(fd[0]);
+        for (size_t from = 0; from < s.size();) {
+            size_t to = std::min(s.size(), (from >> 16 << 16) + (1 << 16));
+            ssize_t r = write(fd[1], s.data() + from, to - from);
+            if (r <= 0) _exit(1);
+            from += r;
+        }
+        _exit(0);
+    }
+    close(fd[1]);
+    vector<ll> got;
+    o.wall = timed([&] {
+        FastInput in(fd[0]);
+        ll x;
+        while (in.next(x)) got.push_back(x);
+    });
+    close(fd[0]);
+    waitpid(writer, nullptr, 0);
+    if (got != want) {
+        size_t i = 0;
+        while (i < got.size() && i < want.size() && got[i] == want[i]) ++i;
+        fprintf(stderr, "fastio_pipe: token %zu read as %lld, sent %lld\n", i,
+                i < got.size() ? got[i] : 0LL, i < want.size() ? want[i] : 0LL);
+        _exit(1);
+    }
+    for (ll x : got) o.check += x;
+    o.items = (double)s.size(), o.unit = "bytes/s";
+    o.size = dims({{"bytes", (ll)s.size()}, {"tokens", (ll)got.size()}});
+    return o;
+}
+
+static vector<Case> cases() {
+    vector<Case> cs;
+    cs.push_back({"fastio_pipe", "boundaries", [](double s, Rng &rng) {
+        return run_fastio_pipe(scaled(256, s), rng);
+    }});
+    for (const char *g : {"random", "powerlaw"}) {
+        string kind = g;
+        cs.push_back({"a1_konig", g, [kind](double s, Rng &rng) {
+            int side = scaled(20000, s);
+            ll m = 5LL * side;
+            Edges e = kind == "random" ? gen::bipartite_random(side, side, m, rng)
+                                       : gen::bipartite_powerlaw(side, side, m, 1.0, rng);
+            return run_konig(e, 2 * side);
+        }});
+    }
+    for (const char *g : {"random", "powerlaw"}) {
+        string kind = g;
+        cs.push_back({"a3_blossom", g, [kind](double s, Rng &rng) {
+            // MAXN caps A3 at 504 vertices, so the repetitions scale instead
+            int n = a3::MAXN - 1;
+            Edges e = kind == "random" ? gen::general_random(n, 4 * n, rng)
+                                       : gen::bipartite_powerlaw(n / 2, n - n / 2, 4 * n, 1.0, rng);
+            return run_blossom(e, n, scaled(2000, s));
+        }});
+    }
+    for (const char *g : {"dense", "geometric"}) {
+        string kind = g;
+        cs.push_back({"b1_hungarian", g, [kind](double s, Rng &rng) {
+            int n = scaled(1500, s, 1.0 / 3);
+            auto c = kind == "dense" ? gen::cost_dense(n, rng) : gen::cost_geometric(n, rng);
+            return run_hungarian(c, n);
+        }});
+    }
+    cs.push_back({"c4_ek", "layered", [](double s, Rng &rng) {
+        return run_maxflow(gen::flow_layered(20, scaled(200, s), 4, rng),
+                           c4::FlowEngine::EdmondsKarp, false);
+    }});
+    cs.push_back({"c4_dinic", "layered", [](double s, Rng &rng) {
+        return run_maxflow(gen::flow_layered(50, scaled(2000, s), 4, rng),
+                           c4::FlowEngine::Dinic, false);
+    }});
+    cs.push_back({"c4_dinic_scaling", "layered", [](double s, Rng &rng) {
+        return run_maxflow(gen::flow_layered(50, scaled(2000, s), 4, rng),
+                           c4::FlowEngine::Dinic, true);
+    }});
+    cs.push_back({"c4_dinic", "grid", [](double s, Rng &rng) {
+        int W = scaled(300, s, 0.5);
+        return run_maxflow(gen::flow_grid(W, W, rng), c4::FlowEngine::Dinic, false);
+    }});
+    cs.push_back({"c4_bk", "grid", [](double s, Rng &rng) {
+        int W = scaled(300, s, 0.5);
+        return run_bk_grid(gen::flow_grid(W, W, rng), W, W);
+    }});
+    for (const char *g : {"random", "sorted", "sawtooth"}) {
+        string kind = g;
+        cs.push_back({"d1_encode", g, [kind](double s, Rng &rng) {
+            return run_d1(gen::rmq_array((size_t)scaled(1 << 22, s), kind, rng), 16);
+        }});
+    }
+    for (const char *g : {"random", "sorted", "sawtooth"}) {
+        string kind = g;
+        cs.push_back({"d2b_build", g, [kind](double s, Rng &rng) {
+            return run_d2_build(gen::rmq_array((size_t)scaled(1 << 24, s), kind, rng));
+        }});
+    }
+    for (const char *g : {"random", "sorted", "sawtooth"}) {
+        string kind = g;
+        cs.push_back({"d2b_query", g, [kind](double s, Rng &rng) {
+            auto a = gen::rmq_array((size_t)scaled(1 << 24, s), kind, rng);
+            return run_d2_query(a, scaled(5000000, s), rng);
+        }});
+    }
+    for (const char *g : {"random", "sawtooth"}) {
+        string kind = g;
+        cs.push_back({"block_rmq", g, [kind](double s, Rng &rng) {
+            auto a = gen::rmq_array((size_t)scaled(1 << 24, s), kind, rng);
+            return run_block_rmq(a, scaled(5000000, s), rng);
+        }});
+        cs.push_back({"d2_succinct", g, [kind](double s, Rng &rng) {
+            auto a = gen::rmq_array((size_t)scaled(1 << 22, s), kind, rng);
+            return run_succinct(a, scaled(1000000, s), rng);
+        }});
+        cs.push_back({"d2_dynamic", g, [kind](double s, Rng &rng) {
+            auto a = gen::rmq_array((size_t)scaled(1 << 22, s), kind, rng);
+            return run_dynamic(a, scaled(2000000, s), 10, rng);
+        }});
+    }
+    for (const char *g : {"random", "path"}) {
+        string kind = g;
+        cs.push_back({"d2_lca", g, [kind](double s, Rng &rng) {
+            auto p = gen::tree_parents(scaled(1 << 22, s), kind, rng);
+            return run_lca(p, scaled(5000000, s), rng);
+        }});
+    }
+    cs.push_back({"c4_mincut_sw", "random", [](double s, Rng &rng) {
+        int n = scaled(400, s, 0.5);
+        return run_global_min_cut(gen::general_random(n, 10LL * n, rng), n, 0, rng);
+    }});
+    cs.push_back({"c4_mincut_ks", "random", [](double s, Rng &rng) {
+        int n = scaled(200, s, 0.5);
+        return run_global_min_cut(gen::general_random(n, 10LL * n, rng), n, 10, rng);
+    }});
+    cs.push_back({"c4_sparsifier", "layered", [](double s, Rng &rng) {
+        return run_sparsifier(gen::flow_layered(50, scaled(2000, s), 4, rng), 4.0);
+    }});
+    return cs;
+}
+
+static long peak_rss_kb() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+    return ru.ru_maxrss / 1024;     // bytes on macOS
+#else
+    return ru.ru_maxrss;
+#endif
+}
+
+int main(int argc, char **argv) {
+    string filter;
+    double scale = 1;
+    unsigned long long seed = 1;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--filter=", 0) == 0) filter = arg.substr(9);
+        else if (arg.rfind("--scale=", 0) == 0) scale = std::stod(arg.substr(8));
+        else if (arg.rfind("--seed=", 0) == 0) seed = std::stoull(arg.substr(7));
+        else if (arg == "--list") list = true;
+        else {
+            fprintf(stderr, "usage: %s [--filter=SUBSTR] [--scale=F] [--seed=S] [--list]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int failed = 0;
+    for (auto &c : cases()) {
+        string id = string(c.name) + "/" + c.gen;
+        if (id.find(filter) == string::npos) continue;
+        if (list) {
+            printf("%s\n", id.c_str());
+            continue;
+        }
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            Rng rng(seed);
+            Outcome o = c.run(scale, rng);
+            printf("{\"version\":\"%s\",\"case\":\"%s\",\"gen\":\"%s\",\"seed\":%llu,"
+                   "\"scale\":%g,\"size\":\"%s\",\"wall_s\":%.6f,\"throughput\":%.1f,"
+                   "\"unit\":\"%s\",\"peak_rss_kb\":%ld,\"check\":%lld}\n",
+                   BENCH_VERSION, c.name, c.gen, seed, scale, o.size.c_str(), o.wall,
+                   o.wall > 0 ? o.items / o.wall : 0.0, o.unit, peak_rss_kb(), o.check);
+            fflush(stdout);
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            printf("{\"version\":\"%s\",\"case\":\"%s\",\"gen\":\"%s\",\"seed\":%llu,"
+                   "\"error\":\"exit status %d\"}\n", BENCH_VERSION, c.name, c.gen, seed, status);
+            ++failed;
+        }
+    }
+    return failed ? 1 : 0;
+}
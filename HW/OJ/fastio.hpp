@@ -0,0 +1,231 @@
+/* Fast I/O shared by the solver mains.
+ *
+ *   FastInput in;                  // stdin: mmap'd if it is a file, else read in chunks
+ *   long long n; int m;
+ *   in.next(n); in.next(m);        // false at end of input
+ *   FastOutput out;                // one large buffer, flushed when full and on exit
+ *   out << n << ' ' << m << '\n';
+ *
+ * Integers are parsed eight digits at a time: the eight bytes are loaded
+ * as one word, checked to all be digits, and combined with three
+ * multiplies (SWAR), falling back to a digit loop for the tail.  Anything
+ * that is not a digit or '-' separates tokens.  Output formats integers
+ * two digits at a time from a table.
+ */
+#ifndef FASTIO_HPP
+#define FASTIO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class FastInput {
+    static const std::size_t CHUNK = 1 << 22;
+    static const std::size_t TOKEN = 64;    // longest token parsed without a refill
+
+    int fd;
+    const char *p = nullptr, *end = nullptr;
+    bool eof = false;
+    void *map = nullptr;
+    std::size_t map_len = 0;
+    std::vector<char> buf;
+
+    // keep at least TOKEN bytes ahead of p unless the input has ended;
+    // next() calls it once p sits on the first byte of a token
+    void refill() {
+        if (eof || std::size_t(end - p) >= TOKEN) return;
+        std::size_t keep = end - p;
+        std::memmove(buf.data(), p, keep);
+        std::size_t len = keep;
+        while (len < CHUNK) {
+            ssize_t r = ::read(fd, buf.data() + len, CHUNK - len);
+            if (r <= 0) { eof = true; break; }
+            len += r;
+            if (len >= TOKEN) break;
+        }
+        p = buf.data();
+        end = p + len;
+    }
+
+    static bool digit(char c) { return c >= '0' && c <= '9'; }
+
+    // value of eight ASCII digits, most significant first
+    static std::uint32_t eight_digits(std::uint64_t v) {
+        v -= 0x3030303030303030ULL;
+        v = v * 10 + (v >> 8);
+        v = ((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)) +
+             ((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))) >> 32;
+        return (std::uint32_t)v;
+    }
+
+    static bool all_digits(std::uint64_t v) {
+        return ((v & 0xF0F0F0F0F0F0F0F0ULL) |
+                (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+               0x3333333333333333ULL;
+    }
+
+public:
+    // reads fd (stdin by default); regular files are mapped whole
+    explicit FastInput(int fd_ = 0) : fd(fd_) {
+        struct stat sb;
+        if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0) {
+            off_t at = lseek(fd, 0, SEEK_CUR);
+            if (at < 0) at = 0;
+            map_len = sb.st_size;
+            void *m = mmap(nullptr, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                madvise(m, map_len, MADV_SEQUENTIAL);
+                map = m;
+                p = static_cast<const char*>(m) + (at < sb.st_size ? at : sb.st_size);
+                end = static_cast<const char*>(m) + map_len;
+                eof = true;
+                return;
+            }
+        }
+        buf.resize(CHUNK);
+        p = end = buf.data();
+    }
+
+    ~FastInput() {
+        if (map) munmap(map, map_len);
+    }
+
+    FastInput(const FastInput &) = delete;
+    FastInput &operator=(const FastInput &) = delete;
+
+    // next integer token into x; false at end of input
+    template <class T>
+    bool next(T &x) {
+        static_assert(std::is_integral<T>::value, "FastInput parses integers");
+        while (true) {
+            while (p < end && !digit(*p) && *p != '-') ++p;
+            if (p < end) break;
+            if (eof) return false;
+            refill();
+        }
+        // the separators may have eaten the lookahead: pull the whole token in
+        refill();
+        bool neg = *p == '-';
+        if (neg && (++p == end || !digit(*p))) return next(x);
+
+        std::uint64_t v = 0;
+        std::uint64_t w;
+        while (end - p >= 8) {
+            std::memcpy(&w, p, 8);
+            if (!all_digits(w)) break;
+            v = v * 100000000 + eight_digits(w);
+            p += 8;
+        }
+        while (p < end && digit(*p)) v = v * 10 + (*p++ - '0');
+        x = neg ? T(0 - v) : T(v);
+        return true;
+    }
+
+    template <class T, class... Rest>
+    bool next(T &x, Rest &...rest) {
+        return next(x) && next(rest...);
+    }
+};
+
+class FastOutput {
+    static const std::size_t CHUNK = 1 << 22;
+
+    std::FILE *f;
+    char *buf;
+    std::size_t len = 0;
+
+    void reserve(std::size_t n) {
+        if (len + n > CHUNK) flush();
+    }
+
+    template <class U>
+    void put_unsigned(U v) {
+        static const char pairs[201] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        char tmp[24];
+        int i = 24;
+        while (v >= 100) {
+            unsigned d = unsigned(v % 100) * 2;
+            v /= 100;
+            tmp[--i] = pairs[d + 1];
+            tmp[--i] = pairs[d];
+        }
+        if (v >= 10) {
+            tmp[--i] = pairs[v * 2 + 1];
+            tmp[--i] = pairs[v * 2];
+        } else {
+            tmp[--i] = char('0' + v);
+        }
+        std::memcpy(buf + len, tmp + i, 24 - i);
+        len += 24 - i;
+    }
+
+public:
+    explicit FastOutput(std::FILE *f_ = stdout) : f(f_), buf(new char[CHUNK]) {}
+
+    ~FastOutput() {
+        flush();
+        delete[] buf;
+    }
+
+    FastOutput(const FastOutput &) = delete;
+    FastOutput &operator=(const FastOutput &) = delete;
+
+    void flush() {
+        if (len) std::fwrite(buf, 1, len, f);
+        len = 0;
+        std::fflush(f);
+    }
+
+    void write(const char *s, std::size_t n) {
+        if (n > CHUNK) {
+            flush();
+            std::fwrite(s, 1, n, f);
+            return;
+        }
+        reserve(n);
+        std::memcpy(buf + len, s, n);
+        len += n;
+    }
+
+    FastOutput &operator<<(char c) {
+        reserve(1);
+        buf[len++] = c;
+        return *this;
+    }
+
+    FastOutput &operator<<(const char *s) {
+        write(s, std::strlen(s));
+        return *this;
+    }
+
+    FastOutput &operator<<(const std::string &s) {
+        write(s.data(), s.size());
+        return *this;
+    }
+
+    template <class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+    FastOutput &operator<<(T v) {
+        reserve(24);
+        typedef typename std::make_unsigned<T>::type U;
+        if (v < 0) {
+            buf[len++] = '-';
+            put_unsigned(U(0) - U(v));
+        } else {
+            put_unsigned(U(v));
+        }
+        return *this;
+    }
+};
+
+#endif